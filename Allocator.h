@@ -0,0 +1,183 @@
+﻿#pragma once
+#include <atomic>
+#include <cstddef>
+
+/**
+ * Vector、List 和 Queue 使用的内存分配策略。
+ *
+ * 分配策略是一个只有静态成员函数模板的类：allocate / deallocate 分配和释放元素数组，
+ * create / destroy 分配和释放单个对象（链表节点）。数组仍用 new[] 分配，元素先默认构造再赋值，
+ * 与容器原来的行为一致。
+ */
+struct NewAllocator {
+	template<typename T>
+	static T* allocate(size_t n) {
+		return new T[n];
+	}
+
+	template<typename T>
+	static void deallocate(T* p, size_t) {
+		delete[] p;
+	}
+
+	template<typename T, typename... Args>
+	static T* create(const Args&... args) {
+		return new T(args...);
+	}
+
+	template<typename T>
+	static void destroy(T* p) {
+		delete p;
+	}
+};
+
+/**
+ * 全局的堆分配计数：分配次数、累计请求字节数、当前占用字节数和占用峰值。
+ * 计数是原子的，工作线程中的容器也可以安全地计数。
+ */
+class AllocationCounters {
+private:
+	struct State {
+		std::atomic<size_t> count;
+		std::atomic<size_t> bytes;
+		std::atomic<size_t> liveBytes;
+		std::atomic<size_t> peakLiveBytes;
+		State() : count(0), bytes(0), liveBytes(0), peakLiveBytes(0) {}
+	};
+
+	static State& state() {
+		static State instance;
+		return instance;
+	}
+
+public:
+	/**
+	 * 记录一次分配。
+	 *
+	 * @param bytes 请求的字节数
+	 */
+	static void recordAllocate(size_t bytes) {
+		State& s = state();
+		s.count++;
+		s.bytes += bytes;
+		size_t live = s.liveBytes += bytes;
+		size_t peak = s.peakLiveBytes.load();
+		while (live > peak && !s.peakLiveBytes.compare_exchange_weak(peak, live)) {
+		}
+	}
+
+	/**
+	 * 记录一次释放。
+	 *
+	 * @param bytes 分配时请求的字节数
+	 */
+	static void recordRelease(size_t bytes) {
+		state().liveBytes -= bytes;
+	}
+
+	static size_t count() {
+		return state().count.load();
+	}
+
+	static size_t bytes() {
+		return state().bytes.load();
+	}
+
+	static size_t liveBytes() {
+		return state().liveBytes.load();
+	}
+
+	static size_t peakLiveBytes() {
+		return state().peakLiveBytes.load();
+	}
+
+	/**
+	 * 把占用峰值重置为当前占用，用于测量某一段代码的峰值。
+	 */
+	static void resetPeak() {
+		state().peakLiveBytes.store(state().liveBytes.load());
+	}
+};
+
+/**
+ * 在 NewAllocator 的基础上把每次分配和释放记入 AllocationCounters 的分配策略。
+ * 字节数按请求的 n * sizeof(T) 计，不含 new[] 自身的额外开销。
+ */
+struct CountingAllocator {
+	template<typename T>
+	static T* allocate(size_t n) {
+		AllocationCounters::recordAllocate(n * sizeof(T));
+		return NewAllocator::allocate<T>(n);
+	}
+
+	template<typename T>
+	static void deallocate(T* p, size_t n) {
+		if (p != nullptr) {
+			AllocationCounters::recordRelease(n * sizeof(T));
+		}
+		NewAllocator::deallocate(p, n);
+	}
+
+	template<typename T, typename... Args>
+	static T* create(const Args&... args) {
+		AllocationCounters::recordAllocate(sizeof(T));
+		return NewAllocator::create<T>(args...);
+	}
+
+	template<typename T>
+	static void destroy(T* p) {
+		if (p != nullptr) {
+			AllocationCounters::recordRelease(sizeof(T));
+		}
+		NewAllocator::destroy(p);
+	}
+};
+
+/**
+ * 测量一段代码的堆分配：构造时记下当前计数并重置占用峰值，之后读取增量。
+ * 同一时刻只应有一个活动的 AllocationScope（峰值是全局的）。
+ */
+class AllocationScope {
+private:
+	size_t startCount;
+	size_t startBytes;
+	size_t startLiveBytes;
+
+public:
+	AllocationScope()
+		: startCount(AllocationCounters::count()), startBytes(AllocationCounters::bytes()),
+		startLiveBytes(AllocationCounters::liveBytes()) {
+		AllocationCounters::resetPeak();
+	}
+
+	/**
+	 * @return 期间的分配次数
+	 */
+	size_t allocations() const {
+		return AllocationCounters::count() - startCount;
+	}
+
+	/**
+	 * @return 期间累计请求的字节数
+	 */
+	size_t bytes() const {
+		return AllocationCounters::bytes() - startBytes;
+	}
+
+	/**
+	 * @return 期间占用峰值比开始时多出的字节数
+	 */
+	size_t peakBytes() const {
+		size_t peak = AllocationCounters::peakLiveBytes();
+		return peak > startLiveBytes ? peak - startLiveBytes : 0;
+	}
+};
+
+// 定义 KNIGHT_TRACK_ALLOCATIONS 时所有容器默认使用 CountingAllocator
+#ifdef KNIGHT_TRACK_ALLOCATIONS
+typedef CountingAllocator DefaultAllocator;
+const bool ALLOCATION_TRACKING_ENABLED = true;
+#else
+typedef NewAllocator DefaultAllocator;
+const bool ALLOCATION_TRACKING_ENABLED = false;
+#endif
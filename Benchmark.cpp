@@ -0,0 +1,377 @@
+﻿#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <nlohmann/json.hpp>
+
+#include "Chessboard.h"
+#include "UnboundedBoard.h"
+#include "MultiSourceDistance.h"
+#include "ShortestPaths.h"
+#include "Vector.h"
+#include "Allocator.h"
+
+/**
+ * 求解器性能基准程序，与主程序分开编译（Benchmark.vcxproj），不读 input.txt，也不打开图像窗口。
+ *
+ * 在一组棋盘大小和距离类别上依次运行各个求解器，每个组合先预热若干次再重复计时，
+ * 输出最短、中位数和 p99 耗时（微秒），格式为 CSV 或 JSON，便于跟踪性能回退。
+ * 定义 KNIGHT_TRACK_ALLOCATIONS 编译时，还会额外运行一次并输出该次的堆分配次数、请求字节数和占用峰值。
+ *
+ * 用法：Benchmark [--sizes 8,16,...] [--reps N] [--warmup N] [--solvers bfs,bb,...]
+ *                 [--format csv|json] [--output 文件名] [--no-limits]
+ */
+
+typedef Chessboard::Position Position;
+
+/**
+ * 一次计时所需的上下文。
+ */
+struct BenchContext {
+	Chessboard* board; // 已设置好查询的棋盘
+	UnboundedBoard* bounded; // 与棋盘同样大小的哈希表求解器
+	MultiSourceDistance* multiSource; // 与棋盘同样大小的位并行距离引擎
+	Position start; // 起始位置
+	Position target; // 目标位置
+};
+
+/**
+ * 求解器条目：名称、默认允许的最大棋盘，以及运行一次并返回跳数的函数（不可达返回 -1）。
+ */
+struct BenchSolver {
+	const char* name;
+	int maxBoardSize; // 超过该大小时默认跳过，0 表示不限
+	long long (*run)(BenchContext& ctx);
+	bool keepCache; // 为 true 时各次运行之间保留棋盘按起点缓存的距离场，否则每次运行前清空
+};
+
+// 棋盘按起点缓存的距离场个数，与 Chessboard 构造时的默认值相同
+static const size_t SOURCE_CACHE_CAPACITY = 8;
+
+static long long pathJumps(const Vector<Position>& path) {
+	return (long long)path.size() - 1;
+}
+
+static long long runBFS(BenchContext& ctx) {
+	return pathJumps(ctx.board->optimalPathBFS());
+}
+
+static long long runLayered(BenchContext& ctx) {
+	return pathJumps(ctx.board->optimalPathLayeredBFS());
+}
+
+static long long runLayeredPacked(BenchContext& ctx) {
+	return pathJumps(ctx.board->optimalPathLayeredBFS(true));
+}
+
+static long long runSymmetric(BenchContext& ctx) {
+	return pathJumps(ctx.board->symmetricPathBFS());
+}
+
+static long long runBranchBound(BenchContext& ctx) {
+	return pathJumps(ctx.board->branchBoundPath());
+}
+
+static long long runDFS(BenchContext& ctx) {
+	return pathJumps(ctx.board->feasiblePathDFS());
+}
+
+static long long runMinJumps(BenchContext& ctx) {
+	return ctx.board->minJumpsBFS();
+}
+
+static long long runShortest(BenchContext& ctx) {
+	return pathJumps(ctx.board->shortestPath());
+}
+
+static long long runBidirectional(BenchContext& ctx) {
+	return pathJumps(ctx.bounded->shortestPath(ctx.start, ctx.target));
+}
+
+static long long runDistanceField(BenchContext& ctx) {
+	Vector<unsigned short> field = ctx.board->distanceField(true);
+	size_t idx = (size_t)(ctx.target.x - 1) * ctx.board->size() + (ctx.target.y - 1);
+	unsigned short jumps = field.begin()[idx];
+	return jumps == Chessboard::UNREACHED ? -1 : jumps;
+}
+
+static long long runMultiSource(BenchContext& ctx) {
+	Vector<Position> sources;
+	sources.push_back(ctx.start);
+	if (!ctx.multiSource->compute(sources)) {
+		return -1;
+	}
+	return ctx.multiSource->distance(0, ctx.target);
+}
+
+// 保存 count() 的结果，防止调用被优化掉
+static volatile unsigned long long countSink;
+
+static long long runCount(BenchContext& ctx) {
+	ShortestPaths paths(*ctx.board, ctx.start, ctx.target);
+	if (paths.jumps() >= 0) {
+		countSink = paths.count();
+	}
+	return paths.jumps();
+}
+
+// feasiblePathDFS 的路径长度和回溯次数随棋盘面积增长，大棋盘默认跳过；
+// 其余整盘网格的求解器在 8192 时需要数 GB 内存，默认只跑到 4096
+static const BenchSolver SOLVERS[] = {
+	{ "bfs", 4096, runBFS, false },
+	{ "layered", 4096, runLayered, false },
+	{ "layered-packed", 8192, runLayeredPacked, false },
+	{ "symmetric", 4096, runSymmetric, false },
+	{ "symmetric-cached", 4096, runSymmetric, true },
+	{ "bb", 4096, runBranchBound, false },
+	{ "dfs", 64, runDFS, false },
+	{ "minjumps", 4096, runMinJumps, false },
+	{ "shortest", 4096, runShortest, false },
+	{ "bidirectional", 0, runBidirectional, false },
+	{ "distance-field", 4096, runDistanceField, false },
+	{ "multisource", 2048, runMultiSource, false },
+	{ "count", 4096, runCount, false },
+};
+
+static const int SOLVER_COUNT = sizeof(SOLVERS) / sizeof(SOLVERS[0]);
+
+/**
+ * 距离类别：近（中心附近 3 跳左右）、中（四分之一棋盘）、远（对角）。
+ */
+static const char* const DISTANCE_CLASSES[] = { "near", "mid", "far" };
+
+static void distanceQuery(int cls, int boardSize, Position& start, Position& target) {
+	int center = (boardSize + 1) / 2;
+	if (cls == 0) {
+		start = Position(center, center);
+		target = Position(std::min(center + 4, boardSize), std::min(center + 3, boardSize));
+	} else if (cls == 1) {
+		start = Position(1, 1);
+		target = Position(std::max(boardSize / 4, 1), std::max(boardSize / 4 + 1, 1));
+	} else {
+		start = Position(1, 1);
+		target = Position(boardSize, boardSize);
+	}
+}
+
+/**
+ * 一个 (求解器, 棋盘, 距离) 组合的计时结果。
+ */
+struct BenchResult {
+	const char* solver;
+	int boardSize;
+	const char* distance;
+	long long jumps;
+	int reps;
+	double minMicros;
+	double medianMicros;
+	double p99Micros;
+	size_t allocations; // 单次运行的堆分配次数（需要 KNIGHT_TRACK_ALLOCATIONS）
+	size_t allocatedBytes; // 单次运行请求的字节数
+	size_t peakBytes; // 单次运行的占用峰值
+};
+
+/**
+ * 取有序样本的 p 分位数（最近秩法）。
+ */
+static double percentile(const std::vector<double>& sorted, double p) {
+	size_t rank = (size_t)(p * sorted.size() + 0.999999);
+	if (rank < 1) {
+		rank = 1;
+	}
+	if (rank > sorted.size()) {
+		rank = sorted.size();
+	}
+	return sorted[rank - 1];
+}
+
+/**
+ * 设置查询，需要时清空距离场缓存，使每次运行都从冷缓存开始（不计入计时）。
+ */
+static void prepare(const BenchSolver& solver, BenchContext& ctx) {
+	if (!solver.keepCache) {
+		ctx.board->setSourceCacheCapacity(SOURCE_CACHE_CAPACITY);
+	}
+	ctx.board->setQuery(ctx.start, ctx.target);
+}
+
+static BenchResult measure(const BenchSolver& solver, BenchContext& ctx, const char* distance, int warmup, int reps) {
+	long long jumps = -1;
+	for (int i = 0; i < warmup; i++) {
+		prepare(solver, ctx);
+		jumps = solver.run(ctx);
+	}
+
+	std::vector<double> samples;
+	samples.reserve(reps);
+	for (int i = 0; i < reps; i++) {
+		prepare(solver, ctx);
+		auto begin = std::chrono::steady_clock::now();
+		jumps = solver.run(ctx);
+		auto end = std::chrono::steady_clock::now();
+		samples.push_back(std::chrono::duration<double, std::micro>(end - begin).count());
+	}
+	std::sort(samples.begin(), samples.end());
+
+	BenchResult result;
+	result.allocations = 0;
+	result.allocatedBytes = 0;
+	result.peakBytes = 0;
+	if (ALLOCATION_TRACKING_ENABLED) {
+		// 计数不计入上面的计时
+		prepare(solver, ctx);
+		AllocationScope scope;
+		solver.run(ctx);
+		result.allocations = scope.allocations();
+		result.allocatedBytes = scope.bytes();
+		result.peakBytes = scope.peakBytes();
+	}
+	result.solver = solver.name;
+	result.boardSize = ctx.board->size();
+	result.distance = distance;
+	result.jumps = jumps;
+	result.reps = reps;
+	result.minMicros = samples.front();
+	result.medianMicros = percentile(samples, 0.5);
+	result.p99Micros = percentile(samples, 0.99);
+	return result;
+}
+
+static std::vector<std::string> splitList(const char* text) {
+	std::vector<std::string> items;
+	std::stringstream ss(text);
+	std::string item;
+	while (std::getline(ss, item, ',')) {
+		if (!item.empty()) {
+			items.push_back(item);
+		}
+	}
+	return items;
+}
+
+static void writeCsv(const std::vector<BenchResult>& results, std::ostream& out) {
+	out << "solver,board,distance,jumps,reps,min_us,median_us,p99_us";
+	if (ALLOCATION_TRACKING_ENABLED) {
+		out << ",allocs,alloc_bytes,peak_bytes";
+	}
+	out << '\n';
+	for (size_t i = 0; i < results.size(); i++) {
+		const BenchResult& r = results[i];
+		out << r.solver << ',' << r.boardSize << ',' << r.distance << ',' << r.jumps << ',' << r.reps << ','
+			<< r.minMicros << ',' << r.medianMicros << ',' << r.p99Micros;
+		if (ALLOCATION_TRACKING_ENABLED) {
+			out << ',' << r.allocations << ',' << r.allocatedBytes << ',' << r.peakBytes;
+		}
+		out << '\n';
+	}
+}
+
+static void writeJsonResults(const std::vector<BenchResult>& results, std::ostream& out) {
+	nlohmann::ordered_json rows = nlohmann::ordered_json::array();
+	for (size_t i = 0; i < results.size(); i++) {
+		const BenchResult& r = results[i];
+		nlohmann::ordered_json row;
+		row["solver"] = r.solver;
+		row["boardSize"] = r.boardSize;
+		row["distance"] = r.distance;
+		row["jumps"] = r.jumps;
+		row["reps"] = r.reps;
+		row["minMicros"] = r.minMicros;
+		row["medianMicros"] = r.medianMicros;
+		row["p99Micros"] = r.p99Micros;
+		if (ALLOCATION_TRACKING_ENABLED) {
+			row["allocations"] = r.allocations;
+			row["allocatedBytes"] = r.allocatedBytes;
+			row["peakBytes"] = r.peakBytes;
+		}
+		rows.push_back(row);
+	}
+	out << rows.dump(2) << '\n';
+}
+
+int main(int argc, char* argv[]) {
+	std::vector<int> sizes = { 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192 };
+	std::vector<std::string> selected;
+	int reps = 20;
+	int warmup = 2;
+	bool json = false;
+	bool noLimits = false;
+	const char* outputName = nullptr;
+
+	for (int i = 1; i < argc; i++) {
+		bool hasValue = i + 1 < argc;
+		if (strcmp(argv[i], "--sizes") == 0 && hasValue) {
+			sizes.clear();
+			std::vector<std::string> items = splitList(argv[++i]);
+			for (size_t k = 0; k < items.size(); k++) {
+				sizes.push_back(atoi(items[k].c_str()));
+			}
+		} else if (strcmp(argv[i], "--reps") == 0 && hasValue) {
+			reps = std::max(atoi(argv[++i]), 1);
+		} else if (strcmp(argv[i], "--warmup") == 0 && hasValue) {
+			warmup = std::max(atoi(argv[++i]), 0);
+		} else if (strcmp(argv[i], "--solvers") == 0 && hasValue) {
+			selected = splitList(argv[++i]);
+		} else if (strcmp(argv[i], "--format") == 0 && hasValue) {
+			json = strcmp(argv[++i], "json") == 0;
+		} else if (strcmp(argv[i], "--output") == 0 && hasValue) {
+			outputName = argv[++i];
+		} else if (strcmp(argv[i], "--no-limits") == 0) {
+			noLimits = true;
+		} else {
+			std::cerr << "未知参数: " << argv[i] << std::endl;
+			return 1;
+		}
+	}
+
+	std::vector<BenchResult> results;
+	for (size_t s = 0; s < sizes.size(); s++) {
+		int boardSize = sizes[s];
+		if (boardSize < 1) {
+			continue;
+		}
+		Chessboard board(boardSize);
+		UnboundedBoard bounded(boardSize);
+		MultiSourceDistance multiSource(boardSize);
+
+		for (int cls = 0; cls < 3; cls++) {
+			BenchContext ctx = { &board, &bounded, &multiSource, Position(), Position() };
+			distanceQuery(cls, boardSize, ctx.start, ctx.target);
+
+			for (int k = 0; k < SOLVER_COUNT; k++) {
+				const BenchSolver& solver = SOLVERS[k];
+				if (!selected.empty() && std::find(selected.begin(), selected.end(), solver.name) == selected.end()) {
+					continue;
+				}
+				if (!noLimits && solver.maxBoardSize != 0 && boardSize > solver.maxBoardSize) {
+					continue;
+				}
+				results.push_back(measure(solver, ctx, DISTANCE_CLASSES[cls], warmup, reps));
+				std::cerr << solver.name << " N=" << boardSize << " " << DISTANCE_CLASSES[cls]
+					<< " 中位数 " << results.back().medianMicros << " 微秒" << std::endl;
+			}
+		}
+	}
+
+	std::ofstream file;
+	if (outputName != nullptr) {
+		file.open(outputName);
+		if (!file) {
+			std::cerr << "无法打开输出文件: " << outputName << std::endl;
+			return 1;
+		}
+	}
+	std::ostream& out = outputName != nullptr ? file : std::cout;
+	if (json) {
+		writeJsonResults(results, out);
+	} else {
+		writeCsv(results, out);
+	}
+
+	return 0;
+}
@@ -0,0 +1,96 @@
+﻿#pragma once
+#include <cstdint>
+#include <cstring>
+
+/**
+ * 二进制结果文件格式（小端序），供其他服务直接内存映射读取。
+ *
+ * 文件头固定 32 字节（BinaryHeader），之后紧跟负载：
+ * - 路径（BINARY_KIND_PATH）：count 为跳数（不可达时为 BINARY_NO_PATH 且没有负载），每跳用 3 位记录走法编号（Chessboard 中 dx/dy 的下标），
+ *   从起点出发依次排列，低位优先打包，末尾按字节补齐。
+ * - 距离场（BINARY_KIND_DISTANCE_MAP）：count 为格子数 N * N，负载是 N * N 个 uint16，
+ *   按 (x - 1) * N + (y - 1) 排列，0xFFFF 表示不可达。负载从第 32 字节开始，映射后可直接当作 uint16 数组使用。
+ * - 跳数表（BINARY_KIND_DISTANCE_TABLE）：count 为基本区域中的起点数，每个起点一行 N * N 个 uint8，
+ *   排列方式与距离场相同，0xFF 表示不可达（见 DistanceTable.h）。
+ * - 查询（BINARY_KIND_QUERIES）：count 为查询数，每个查询 4 个 int32（起点横纵坐标、终点横纵坐标），
+ *   文件头中的起点和终点不使用，boardSize 为 0 表示未指定（见 QueryReader.h）。
+ */
+struct BinaryHeader {
+	char magic[4]; // 固定为 "KJMP"
+	uint16_t version; // 格式版本
+	uint16_t kind; // 负载类型
+	uint32_t boardSize; // 棋盘大小
+	int32_t startX; // 起点横坐标
+	int32_t startY; // 起点纵坐标
+	int32_t targetX; // 终点横坐标
+	int32_t targetY; // 终点纵坐标
+	uint32_t count; // 负载元素个数
+};
+
+static_assert(sizeof(BinaryHeader) == 32, "BinaryHeader must be 32 bytes");
+
+const char BINARY_MAGIC[4] = { 'K', 'J', 'M', 'P' };
+const uint16_t BINARY_VERSION = 1;
+const uint16_t BINARY_KIND_PATH = 1;
+const uint16_t BINARY_KIND_DISTANCE_MAP = 2;
+const uint16_t BINARY_KIND_DISTANCE_TABLE = 3;
+const uint16_t BINARY_KIND_QUERIES = 4;
+const uint32_t BINARY_NO_PATH = 0xFFFFFFFF; // 路径文件中表示不可达的 count
+
+/**
+ * 填写文件头。
+ *
+ * @param kind 负载类型
+ * @param boardSize 棋盘大小
+ * @param startX 起点横坐标
+ * @param startY 起点纵坐标
+ * @param targetX 终点横坐标
+ * @param targetY 终点纵坐标
+ * @param count 负载元素个数
+ * @return 文件头
+ */
+inline BinaryHeader makeBinaryHeader(uint16_t kind, int boardSize, int startX, int startY, int targetX, int targetY, uint32_t count) {
+	BinaryHeader header;
+	memcpy(header.magic, BINARY_MAGIC, 4);
+	header.version = BINARY_VERSION;
+	header.kind = kind;
+	header.boardSize = (uint32_t)boardSize;
+	header.startX = startX;
+	header.startY = startY;
+	header.targetX = targetX;
+	header.targetY = targetY;
+	header.count = count;
+	return header;
+}
+
+/**
+ * 检查一段内存是否以合法的文件头开始，并且负载完整。
+ *
+ * @param data 文件内容
+ * @param size 文件大小
+ * @param kind 期望的负载类型
+ * @return 合法时返回文件头指针，否则返回 nullptr
+ */
+inline const BinaryHeader* binaryHeader(const char* data, size_t size, uint16_t kind) {
+	if (data == nullptr || size < sizeof(BinaryHeader)) {
+		return nullptr;
+	}
+	const BinaryHeader* header = (const BinaryHeader*)data;
+	if (memcmp(header->magic, BINARY_MAGIC, 4) != 0 || header->version != BINARY_VERSION || header->kind != kind) {
+		return nullptr;
+	}
+	size_t payload = 0;
+	if (kind == BINARY_KIND_DISTANCE_MAP) {
+		payload = (size_t)header->count * 2;
+	} else if (kind == BINARY_KIND_DISTANCE_TABLE) {
+		payload = (size_t)header->count * header->boardSize * header->boardSize;
+	} else if (kind == BINARY_KIND_QUERIES) {
+		payload = (size_t)header->count * 4 * sizeof(int32_t);
+	} else if (header->count != BINARY_NO_PATH) {
+		payload = ((size_t)header->count * 3 + 7) / 8;
+	}
+	if (size - sizeof(BinaryHeader) < payload) {
+		return nullptr;
+	}
+	return header;
+}
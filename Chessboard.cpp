@@ -2,28 +2,61 @@
 #include <fstream>
 #include <iomanip>
 #include <chrono>
+#include <climits>
+#include <cstring>
+#include <algorithm>
+#include <cstdlib>
+#include <queue>
+#include <vector>
 #include <nlohmann/json.hpp>
+#ifndef KNIGHT_HEADLESS
 #include <opencv2/opencv.hpp>
+#endif
 
 #include "Chessboard.h"
 #include "Vector.h"
 #include "Queue.h"
+#include "TextBuffer.h"
+#include "MappedFile.h"
+#include "BinaryFormat.h"
+#include "Symmetry.h"
+#include "Allocator.h"
+#include "RasterImage.h"
+#include "QueryReader.h"
+#include "OutputSink.h"
 
 using namespace std;
+#ifndef KNIGHT_HEADLESS
 using namespace cv;
+#endif
 using json = nlohmann::json;
 
+const unsigned short Chessboard::UNREACHED;
+const unsigned long long Chessboard::GRID_MEMORY_BUDGET;
+const int Chessboard::MAX_BOARD_SIZE;
+const int Chessboard::dx[8] = { 1, 2, 2, 1, -1, -2, -2, -1 };
+const int Chessboard::dy[8] = { 2, 1, -1, -2, -2, -1, 1, 2 };
+
 /**
 * 默认构造函数。设置棋盘大小为200，当前跳数为无穷大。
 */
-Chessboard::Chessboard() : boardSize(200), currJumps(INT_MAX) {}
+Chessboard::Chessboard() : boardSize(200), currJumps(INT_MAX), visited(boardSize + 1), sourceCacheCapacity(8), sourceCacheNext(0), displayEnabled(true), asyncOutput(false) {}
 
 /**
 * 构造函数。根据给定的棋盘大小，初始化棋盘和当前跳数。
 *
 * @param boardSize_ 棋盘大小
 */
-Chessboard::Chessboard(int boardSize_) : boardSize(boardSize_), currJumps(INT_MAX) {}
+Chessboard::Chessboard(int boardSize_) : boardSize(boardSize_), currJumps(INT_MAX), visited(boardSize + 1), sourceCacheCapacity(8), sourceCacheNext(0), displayEnabled(true), asyncOutput(false) {}
+
+/**
+* 获取棋盘大小。
+*
+* @return 棋盘大小
+*/
+int Chessboard::size() const {
+	return boardSize;
+}
 
 /**
 * 检查坐标是否在合法的范围内。
@@ -36,41 +69,62 @@ bool Chessboard::isValid(int x, int y) {
 	return (x >= 1 && x <= boardSize && y >= 1 && y <= boardSize);
 }
 
+/**
+* 设置起始位置和目标位置，供不经过 input.txt 的调用方使用。
+*
+* @param start_ 起始位置
+* @param target_ 目标位置
+*/
+void Chessboard::setQuery(const Position& start_, const Position& target_) {
+	start = start_;
+	target = target_;
+}
+
 /**
 * 使用广度优先搜索算法寻找最优路径。
+* 跳数和父节点保存在跨查询复用的 scratch 网格中，以代数区分本次查询写入的格子，
+* 因此每次查询不需要 O(N^2) 的初始化。
 *
 * @return 最优路径的位置列表
 */
 Vector<Chessboard::Position> Chessboard::optimalPathBFS() {
-	Vector<Vector<int>> board(boardSize + 1, Vector<int>(boardSize + 1, -1));
-	Vector<Vector<Position>> parent(boardSize + 1, Vector<Position>(boardSize + 1, { -1, -1 }));
-	board[start.x][start.y] = 0;
+	SearchRecorder rec(stats);
+	rec.reset();
+	if (!isValid(start.x, start.y) || !isValid(target.x, target.y)) {
+		return Vector<Position>();
+	}
+	scratch.reset((size_t)boardSize * boardSize);
+	rec.scratch(scratch.allocatedBytes());
+	scratch.at(cellIndex(start.x, start.y)) = { 0, Position(-1, -1) };
 
 	Queue<Position> q;
 	q.push(start);
+	rec.pushed(q.size());
 
 	while (!q.empty()) {
 		Position curr = q.front();
 		q.pop();
+		rec.popped();
 
 		if (curr.x == target.x && curr.y == target.y) {
 			Vector<Position> path;
 			while (!(curr.x == start.x && curr.y == start.y)) {
 				path.push_back(curr);
-				curr = parent[curr.x][curr.y];
+				curr = scratch.get(cellIndex(curr.x, curr.y)).parent;
 			}
 			path.push_back(start);
 			return path;
 		}
 
+		int nextJump = scratch.get(cellIndex(curr.x, curr.y)).jumps + 1;
 		for (int i = 0; i < 8; i++) {
 			int nextX = curr.x + dx[i];
 			int nextY = curr.y + dy[i];
 
-			if (isValid(nextX, nextY) && board[nextX][nextY] == -1) {
-				board[nextX][nextY] = board[curr.x][curr.y] + 1;
-				parent[nextX][nextY] = curr;
+			if (rec.checked(isValid(nextX, nextY)) && !scratch.contains(cellIndex(nextX, nextY))) {
+				scratch.at(cellIndex(nextX, nextY)) = { nextJump, curr };
 				q.push(Position(nextX, nextY));
+				rec.pushed(q.size());
 			}
 		}
 	}
@@ -79,37 +133,507 @@ Vector<Chessboard::Position> Chessboard::optimalPathBFS() {
 }
 
 /**
-* 使用深度优先搜索算法寻找可行路径。
+* 多起点、多终点的广度优先搜索：所有起点同时以跳数 0 加入队列，
+* 第一个被弹出的终点就是离某个起点最近的终点。一次搜索即可回答
+* “M 匹马中哪一匹最快到达目标”以及“离起点最近的是 M 个目标中的哪一个”。
+*
+* @param sources 起点列表
+* @param targets 终点列表
+* @param sourceIndex 输出，获胜起点在 sources 中的下标，不可达时为 -1
+* @param targetIndex 输出，到达的终点在 targets 中的下标，不可达时为 -1
+* @return 从获胜起点到该终点的最优路径（终点在前）
+*/
+Vector<Chessboard::Position> Chessboard::nearestPathBFS(const Vector<Position>& sources, const Vector<Position>& targets, int& sourceIndex, int& targetIndex) {
+	SearchRecorder rec(stats);
+	rec.reset();
+	sourceIndex = -1;
+	targetIndex = -1;
+
+	// 终点按格子下标排序，弹出时二分查找
+	Vector<size_t> targetCells;
+	for (int i = 0; i < targets.size(); i++) {
+		if (isValid(targets[i].x, targets[i].y)) {
+			targetCells.push_back(cellIndex(targets[i].x, targets[i].y));
+		}
+	}
+	sort(targetCells.begin(), targetCells.end());
+	if (targetCells.empty()) {
+		return Vector<Position>();
+	}
+
+	scratch.reset((size_t)boardSize * boardSize);
+	rec.scratch(scratch.allocatedBytes());
+	Queue<Position> q;
+	for (int i = 0; i < sources.size(); i++) {
+		const Position& source = sources[i];
+		if (isValid(source.x, source.y) && !scratch.contains(cellIndex(source.x, source.y))) {
+			scratch.at(cellIndex(source.x, source.y)) = { 0, Position(-1, -1) };
+			q.push(source);
+			rec.pushed(q.size());
+		}
+	}
+
+	while (!q.empty()) {
+		Position curr = q.front();
+		q.pop();
+		rec.popped();
+
+		size_t currIdx = cellIndex(curr.x, curr.y);
+		if (binary_search(targetCells.begin(), targetCells.end(), currIdx)) {
+			for (int i = 0; i < targets.size(); i++) {
+				if (targets[i].x == curr.x && targets[i].y == curr.y) {
+					targetIndex = i;
+					break;
+				}
+			}
+
+			Vector<Position> path;
+			while (scratch.get(cellIndex(curr.x, curr.y)).jumps > 0) {
+				path.push_back(curr);
+				curr = scratch.get(cellIndex(curr.x, curr.y)).parent;
+			}
+			path.push_back(curr);
+
+			for (int i = 0; i < sources.size(); i++) {
+				if (sources[i].x == curr.x && sources[i].y == curr.y) {
+					sourceIndex = i;
+					break;
+				}
+			}
+			return path;
+		}
+
+		int nextJump = scratch.get(currIdx).jumps + 1;
+		for (int i = 0; i < 8; i++) {
+			int nextX = curr.x + dx[i];
+			int nextY = curr.y + dy[i];
+
+			if (rec.checked(isValid(nextX, nextY)) && !scratch.contains(cellIndex(nextX, nextY))) {
+				scratch.at(cellIndex(nextX, nextY)) = { nextJump, curr };
+				q.push(Position(nextX, nextY));
+				rec.pushed(q.size());
+			}
+		}
+	}
+
+	return Vector<Position>();
+}
+
+/**
+* 计算格子在平铺距离场中的下标，按 (x - 1) * boardSize + (y - 1) 行主序排列。
+*
+* @param x 横坐标
+* @param y 纵坐标
+* @return 平铺下标
+*/
+size_t Chessboard::cellIndex(int x, int y) const {
+	return (size_t)(x - 1) * boardSize + (y - 1);
+}
+
+/**
+* 使用广度优先搜索计算起点到各格子的跳数，结果存放在一块连续的 uint16 缓冲区中。
+* 未到达的格子记为 UNREACHED。
+*
+* @param stopAtTarget 为 true 时在弹出目标位置后立即停止搜索
+* @return 按 cellIndex 排列的距离场
+*/
+Vector<unsigned short> Chessboard::distanceField(bool stopAtTarget) {
+	SearchRecorder(stats).reset();
+	return distanceFieldFrom(start, stopAtTarget ? &target : nullptr);
+}
+
+/**
+* 计算指定源位置的距离场，在弹出 stopAt 后停止。不修改棋盘上的起点和终点。
+*
+* @param source 源位置
+* @param stopAt 弹出后停止搜索的位置
+* @return 按 cellIndex 排列的距离场
+*/
+Vector<unsigned short> Chessboard::distanceField(const Position& source, const Position& stopAt) {
+	SearchRecorder(stats).reset();
+	return distanceFieldFrom(source, &stopAt);
+}
+
+/**
+* 计算以任意位置为源的距离场。
+*
+* @param source 源位置
+* @param stopAt 不为空时在弹出该位置后立即停止搜索
+* @return 按 cellIndex 排列的距离场
+*/
+Vector<unsigned short> Chessboard::distanceFieldFrom(const Position& source, const Position* stopAt) {
+	SearchRecorder rec(stats);
+	Vector<unsigned short> field((size_t)boardSize * boardSize, UNREACHED);
+	rec.allocated();
+	rec.scratch(field.size() * sizeof(unsigned short));
+	if (!isValid(source.x, source.y)) {
+		return field;
+	}
+
+	unsigned short* dist = field.begin();
+	dist[cellIndex(source.x, source.y)] = 0;
+
+	Queue<Position> q;
+	q.push(source);
+	rec.pushed(q.size());
+
+	while (!q.empty()) {
+		Position curr = q.front();
+		q.pop();
+		rec.popped();
+
+		if (stopAt != nullptr && curr.x == stopAt->x && curr.y == stopAt->y) {
+			break;
+		}
+
+		unsigned short nextJump = dist[cellIndex(curr.x, curr.y)] + 1;
+		for (int i = 0; i < 8; i++) {
+			int nextX = curr.x + dx[i];
+			int nextY = curr.y + dy[i];
+
+			if (rec.checked(isValid(nextX, nextY)) && dist[cellIndex(nextX, nextY)] == UNREACHED) {
+				dist[cellIndex(nextX, nextY)] = nextJump;
+				q.push(Position(nextX, nextY));
+				rec.pushed(q.size());
+			}
+		}
+	}
+
+	return field;
+}
+
+/**
+* 设置按起点缓存的距离场个数上限，并清空现有缓存。每个距离场占 2 * N * N 字节。
+*
+* @param capacity 缓存个数上限，为 0 时不缓存
+*/
+void Chessboard::setSourceCacheCapacity(size_t capacity) {
+	sourceCacheCapacity = capacity;
+	sourceCacheNext = 0;
+	sourceCacheKeys = Vector<int>();
+	sourceCacheFields = Vector<Vector<unsigned short>>();
+}
+
+/**
+* 在缓存中查找基本区域起点的距离场。
+*
+* @param canonicalSource 基本区域中的起点
+* @return 距离场，未缓存时返回 nullptr
+*/
+const unsigned short* Chessboard::findCachedField(const Position& canonicalSource) {
+	int key = canonicalIndex(canonicalSource, boardSize);
+	for (int i = 0; i < sourceCacheKeys.size(); i++) {
+		if (sourceCacheKeys[i] == key) {
+			return sourceCacheFields[i].begin();
+		}
+	}
+	return nullptr;
+}
+
+/**
+* 获取基本区域起点的距离场，未缓存时计算并放入缓存（满时按先进先出替换）。
+* 返回的指针在下一次调用前有效。
+*
+* @param canonicalSource 基本区域中的起点
+* @return 距离场
+*/
+const unsigned short* Chessboard::cachedField(const Position& canonicalSource) {
+	const unsigned short* cached = findCachedField(canonicalSource);
+	if (cached != nullptr) {
+		return cached;
+	}
+
+	int key = canonicalIndex(canonicalSource, boardSize);
+	if (sourceCacheCapacity == 0) {
+		// 不缓存时借用一个临时槽位
+		sourceCacheKeys = Vector<int>(1, -1);
+		sourceCacheFields = Vector<Vector<unsigned short>>(1);
+		sourceCacheFields[0] = distanceFieldFrom(canonicalSource, nullptr);
+		return sourceCacheFields[0].begin();
+	}
+	if (sourceCacheKeys.size() < sourceCacheCapacity) {
+		sourceCacheKeys.push_back(key);
+		sourceCacheFields.push_back(Vector<unsigned short>());
+		sourceCacheFields.back() = distanceFieldFrom(canonicalSource, nullptr);
+		return sourceCacheFields.back().begin();
+	}
+
+	int slot = (int)sourceCacheNext;
+	sourceCacheNext = (sourceCacheNext + 1) % sourceCacheCapacity;
+	sourceCacheKeys[slot] = key;
+	sourceCacheFields[slot] = distanceFieldFrom(canonicalSource, nullptr);
+	return sourceCacheFields[slot].begin();
+}
+
+/**
+* 把当前查询映射到规范方向：以 source 为源，用对称变换把它移到基本区域。
+* 起点的规范位置未缓存而终点的已缓存时，交换两端以复用缓存（跳数是对称的）。
+*
+* @param source 输出，原方向下作为源的端点
+* @param dest 输出，原方向下的另一端点
+* @param reversed 输出，是否交换了两端
+* @return 对称变换编号
+*/
+int Chessboard::canonicalQuery(Position& source, Position& dest, bool& reversed) {
+	source = start;
+	dest = target;
+	reversed = false;
+
+	int op = canonicalSymmetry(start, boardSize);
+	if (findCachedField(applySymmetry(op, start, boardSize)) == nullptr) {
+		int targetOp = canonicalSymmetry(target, boardSize);
+		if (findCachedField(applySymmetry(targetOp, target, boardSize)) != nullptr) {
+			source = target;
+			dest = start;
+			reversed = true;
+			op = targetOp;
+		}
+	}
+	return op;
+}
+
+/**
+* 利用棋盘的 8 种对称性寻找最优路径。查询先被映射到起点位于基本区域的规范方向，
+* 在该方向上使用按起点缓存的完整距离场从终点贪心下降求出路径，再逆变换回原方向。
+* 对称的查询共享同一个距离场，冷启动搜索次数和缓存占用最多减少到 1/8。
+*
+* @return 最优路径的位置列表
+*/
+Vector<Chessboard::Position> Chessboard::symmetricPathBFS() {
+	SearchRecorder(stats).reset();
+	if (!isValid(start.x, start.y) || !isValid(target.x, target.y)) {
+		return Vector<Position>();
+	}
+
+	Position source, dest;
+	bool reversed;
+	int op = canonicalQuery(source, dest, reversed);
+	const unsigned short* dist = cachedField(applySymmetry(op, source, boardSize));
+	Position curr = applySymmetry(op, dest, boardSize);
+	if (dist[cellIndex(curr.x, curr.y)] == UNREACHED) {
+		return Vector<Position>();
+	}
+
+	Vector<Position> path;
+	path.push_back(invertSymmetry(op, curr, boardSize));
+	for (int jumps = dist[cellIndex(curr.x, curr.y)]; jumps > 0; jumps--) {
+		for (int i = 0; i < 8; i++) {
+			int prevX = curr.x + dx[i];
+			int prevY = curr.y + dy[i];
+
+			if (isValid(prevX, prevY) && dist[cellIndex(prevX, prevY)] == jumps - 1) {
+				curr = Position(prevX, prevY);
+				break;
+			}
+		}
+		path.push_back(invertSymmetry(op, curr, boardSize));
+	}
+
+	// 交换过两端时路径是从起点到终点的，翻转为终点在前
+	if (reversed) {
+		path.reverse(path.begin(), path.end() - 1);
+	}
+	return path;
+}
+
+/**
+* 利用棋盘对称性和按起点缓存的距离场计算最小跳数。
+*
+* @return 最小跳数，不可达时返回 -1
+*/
+int Chessboard::symmetricMinJumps() {
+	SearchRecorder(stats).reset();
+	if (!isValid(start.x, start.y) || !isValid(target.x, target.y)) {
+		return -1;
+	}
+
+	Position source, dest;
+	bool reversed;
+	int op = canonicalQuery(source, dest, reversed);
+	const unsigned short* dist = cachedField(applySymmetry(op, source, boardSize));
+	Position t = applySymmetry(op, dest, boardSize);
+	unsigned short jumps = dist[cellIndex(t.x, t.y)];
+	return jumps == UNREACHED ? -1 : jumps;
+}
+
+/**
+* 不保存父节点的最优路径搜索。搜索时只记录距离（uint16）或层号模 3（每格 2 位），
+* 结束后从目标位置出发，每次选取距离恰好少 1 的相邻格子，反向重建路径。
+* 马的走法图是二分图，相邻格子的距离只会相差 1，因此层号模 3 足以区分前驱与后继。
+*
+* 原实现每格需要 int 距离和 Position 父节点共 12 字节，这里每格 2 字节或 2 位。
+*
+* @param packedLayers 为 true 时只保存层号模 3（每格 2 位），否则保存 uint16 距离
+* @return 最优路径的位置列表
+*/
+Vector<Chessboard::Position> Chessboard::optimalPathLayeredBFS(bool packedLayers) {
+	SearchRecorder(stats).reset();
+	if (!isValid(start.x, start.y) || !isValid(target.x, target.y)) {
+		return Vector<Position>();
+	}
+	if (packedLayers) {
+		return packedLayerPath();
+	}
+
+	Vector<unsigned short> field = distanceField(true);
+	const unsigned short* dist = field.begin();
+	if (dist[cellIndex(target.x, target.y)] == UNREACHED) {
+		return Vector<Position>();
+	}
+
+	Vector<Position> path;
+	Position curr = target;
+	path.push_back(curr);
+	while (!(curr.x == start.x && curr.y == start.y)) {
+		int prevJump = dist[cellIndex(curr.x, curr.y)] - 1;
+		for (int i = 0; i < 8; i++) {
+			int prevX = curr.x + dx[i];
+			int prevY = curr.y + dy[i];
+
+			if (isValid(prevX, prevY) && dist[cellIndex(prevX, prevY)] == prevJump) {
+				curr = Position(prevX, prevY);
+				break;
+			}
+		}
+		path.push_back(curr);
+	}
+
+	return path;
+}
+
+/**
+* 读取压缩层号网格中某个格子的层号，3 表示未访问。
+*/
+static int packedLayer(const unsigned char* layers, size_t idx) {
+	return (layers[idx >> 2] >> ((idx & 3) << 1)) & 3;
+}
+
+/**
+* 写入压缩层号网格中某个格子的层号。
+*/
+static void setPackedLayer(unsigned char* layers, size_t idx, int layer) {
+	int shift = (int)(idx & 3) << 1;
+	layers[idx >> 2] = (unsigned char)((layers[idx >> 2] & ~(3 << shift)) | (layer << shift));
+}
+
+/**
+* optimalPathLayeredBFS 的压缩模式：逐层扩展，每格只保存层号模 3。
+*
+* @return 最优路径的位置列表
+*/
+Vector<Chessboard::Position> Chessboard::packedLayerPath() {
+	SearchRecorder rec(stats);
+	Vector<unsigned char> grid(((size_t)boardSize * boardSize + 3) / 4, 0xFF);
+	rec.allocated();
+	rec.scratch(grid.size());
+	unsigned char* layers = grid.begin();
+	setPackedLayer(layers, cellIndex(start.x, start.y), 0);
+
+	Queue<Position> q;
+	q.push(start);
+	rec.pushed(q.size());
+
+	int depth = 0;
+	bool found = false;
+	while (!q.empty() && !found) {
+		size_t layerSize = q.size();
+		for (size_t k = 0; k < layerSize; k++) {
+			Position curr = q.front();
+			q.pop();
+			rec.popped();
+
+			if (curr.x == target.x && curr.y == target.y) {
+				found = true;
+				break;
+			}
+
+			for (int i = 0; i < 8; i++) {
+				int nextX = curr.x + dx[i];
+				int nextY = curr.y + dy[i];
+
+				if (rec.checked(isValid(nextX, nextY)) && packedLayer(layers, cellIndex(nextX, nextY)) == 3) {
+					setPackedLayer(layers, cellIndex(nextX, nextY), (depth + 1) % 3);
+					q.push(Position(nextX, nextY));
+					rec.pushed(q.size());
+				}
+			}
+		}
+		if (!found) {
+			depth++;
+		}
+	}
+
+	if (!found) {
+		return Vector<Position>();
+	}
+
+	Vector<Position> path;
+	Position curr = target;
+	path.push_back(curr);
+	for (int jumps = depth; jumps > 0; jumps--) {
+		int prevLayer = (jumps - 1) % 3;
+		for (int i = 0; i < 8; i++) {
+			int prevX = curr.x + dx[i];
+			int prevY = curr.y + dy[i];
+
+			if (isValid(prevX, prevY) && packedLayer(layers, cellIndex(prevX, prevY)) == prevLayer) {
+				curr = Position(prevX, prevY);
+				break;
+			}
+		}
+		path.push_back(curr);
+	}
+
+	return path;
+}
+
+/**
+* 使用深度优先搜索算法寻找可行路径。已访问标记按块惰性分配，每次调用只需 O(1) 清空。
 *
 * @return 可行路径的位置列表
 */
 Vector<Chessboard::Position> Chessboard::feasiblePathDFS() {
-	visited = Vector<Vector<bool>>(boardSize + 1, Vector<bool>(boardSize + 1, false));
-	return backtrack(start, currJumps);
+	SearchRecorder rec(stats);
+	rec.reset();
+	if (!isValid(start.x, start.y)) {
+		return Vector<Position>();
+	}
+	visited.reset();
+	Vector<Position> path = backtrack(start, currJumps);
+	rec.scratch(visited.allocatedBytes());
+	return path;
 }
 
 /**
-* 使用分支限界法寻找最优路径。
+* 使用分支限界法寻找最优路径。与 optimalPathBFS 共用 scratch 暂存网格。
 *
 * @return 最优路径的位置列表
 */
 Vector<Chessboard::Position> Chessboard::branchBoundPath() {
-	Vector<Vector<int>> board(boardSize + 1, Vector<int>(boardSize + 1, -1));
-	Vector<Vector<Position>> parent(boardSize + 1, Vector<Position>(boardSize + 1, { -1, -1 }));
-	board[start.x][start.y] = 0;
+	SearchRecorder rec(stats);
+	rec.reset();
+	if (!isValid(start.x, start.y) || !isValid(target.x, target.y)) {
+		return Vector<Position>();
+	}
+	scratch.reset((size_t)boardSize * boardSize);
+	rec.scratch(scratch.allocatedBytes());
+	scratch.at(cellIndex(start.x, start.y)) = { 0, Position(-1, -1) };
+	size_t targetIdx = cellIndex(target.x, target.y);
 
 	Queue<Position> q;
 	q.push(start);
+	rec.pushed(q.size());
 
 	while (!q.empty()) {
 		Position curr = q.front();
 		q.pop();
+		rec.popped();
 
 		if (curr.x == target.x && curr.y == target.y) {
 			Vector<Position> path;
 			while (!(curr.x == start.x && curr.y == start.y)) {
 				path.push_back(curr);
-				curr = parent[curr.x][curr.y];
+				curr = scratch.get(cellIndex(curr.x, curr.y)).parent;
 			}
 			path.push_back(start);
 			return path;
@@ -119,12 +643,12 @@ Vector<Chessboard::Position> Chessboard::branchBoundPath() {
 			int nextX = curr.x + dx[i];
 			int nextY = curr.y + dy[i];
 
-			if (isValid(nextX, nextY) && board[nextX][nextY] == -1) {
-				int nextJump = board[curr.x][curr.y] + 1;
-				if (nextJump < board[target.x][target.y] || board[target.x][target.y] == -1) {
-					board[nextX][nextY] = nextJump;
-					parent[nextX][nextY] = curr;
+			if (rec.checked(isValid(nextX, nextY)) && !scratch.contains(cellIndex(nextX, nextY))) {
+				int nextJump = scratch.get(cellIndex(curr.x, curr.y)).jumps + 1;
+				if (!scratch.contains(targetIdx) || nextJump < scratch.get(targetIdx).jumps) {
+					scratch.at(cellIndex(nextX, nextY)) = { nextJump, curr };
 					q.push(Position(nextX, nextY));
+					rec.pushed(q.size());
 				}
 			}
 		}
@@ -133,6 +657,76 @@ Vector<Chessboard::Position> Chessboard::branchBoundPath() {
 	return Vector<Position>();
 }
 
+/**
+* 使用 A* 算法寻找最优路径，启发函数为 knightLowerBound（相邻格子的下界最多相差 1，满足一致性），
+* f 相同时优先展开跳数大的节点。与 optimalPathBFS 共用 scratch 暂存网格，
+* 开放表中过期的条目（跳数大于网格中记录的跳数）在弹出时跳过。
+*
+* @return 最优路径的位置列表
+*/
+Vector<Chessboard::Position> Chessboard::astarPath() {
+	SearchRecorder rec(stats);
+	rec.reset();
+	if (!isValid(start.x, start.y) || !isValid(target.x, target.y)) {
+		return Vector<Position>();
+	}
+	scratch.reset((size_t)boardSize * boardSize);
+	rec.scratch(scratch.allocatedBytes());
+	scratch.at(cellIndex(start.x, start.y)) = { 0, Position(-1, -1) };
+
+	typedef std::pair<std::pair<int, int>, size_t> OpenEntry; // ((f, -跳数), 格子下标)
+	std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry> > open;
+	open.push(OpenEntry(std::make_pair(knightLowerBound(target.x - start.x, target.y - start.y), 0), cellIndex(start.x, start.y)));
+	rec.pushed(open.size());
+
+	while (!open.empty()) {
+		OpenEntry entry = open.top();
+		open.pop();
+		int jumps = -entry.first.second;
+		if (jumps != scratch.get(entry.second).jumps) {
+			continue;
+		}
+		rec.popped();
+		Position curr((int)(entry.second / boardSize) + 1, (int)(entry.second % boardSize) + 1);
+
+		if (curr.x == target.x && curr.y == target.y) {
+			Vector<Position> path;
+			while (!(curr.x == start.x && curr.y == start.y)) {
+				path.push_back(curr);
+				curr = scratch.get(cellIndex(curr.x, curr.y)).parent;
+			}
+			path.push_back(start);
+			return path;
+		}
+
+		for (int i = 0; i < 8; i++) {
+			int nextX = curr.x + dx[i];
+			int nextY = curr.y + dy[i];
+			if (!rec.checked(isValid(nextX, nextY))) {
+				continue;
+			}
+			size_t nextIdx = cellIndex(nextX, nextY);
+			if (!scratch.contains(nextIdx) || jumps + 1 < scratch.get(nextIdx).jumps) {
+				scratch.at(nextIdx) = { jumps + 1, curr };
+				int f = jumps + 1 + knightLowerBound(target.x - nextX, target.y - nextY);
+				open.push(OpenEntry(std::make_pair(f, -(jumps + 1)), nextIdx));
+				rec.pushed(open.size());
+			}
+		}
+	}
+
+	return Vector<Position>();
+}
+
+/**
+* 从 curr 出发回溯搜索到目标位置的路径，最多 jumps 跳。使用显式栈而不是递归，
+* 路径长度可达 N * N，递归实现在大棋盘上会耗尽调用栈。访问顺序和结果与递归实现相同：
+* 按 dx / dy 的顺序尝试走法，走不通的格子撤销访问标记。
+*
+* @param curr 当前位置
+* @param jumps 剩余可用跳数
+* @return 路径位置列表（终点在前），找不到时为空
+*/
 Vector<Chessboard::Position> Chessboard::backtrack(Position curr, int jumps) {
 	if (curr.x == target.x && curr.y == target.y) {
 		Vector<Position> path;
@@ -140,91 +734,367 @@ Vector<Chessboard::Position> Chessboard::backtrack(Position curr, int jumps) {
 		return path;
 	}
 
-	if (jumps <= 0 || visited[curr.x][curr.y])
-		return Vector<Position>();
+	if (jumps <= 0 || visited.get(curr.x, curr.y))
+		return Vector<Position>();
+
+	struct Frame {
+		Position pos;
+		int move; // 下一个要尝试的走法
+	};
+
+	SearchRecorder rec(stats);
+	rec.popped();
+	visited.at(curr.x, curr.y) = true;
+	Vector<Frame> stack;
+	stack.push_back({ curr, 0 });
+
+	while (!stack.empty()) {
+		Frame& top = stack.back();
+		if (top.move == 8) {
+			visited.at(top.pos.x, top.pos.y) = false;
+			stack.pop_back();
+			continue;
+		}
+
+		int i = top.move++;
+		int nextX = top.pos.x + dx[i];
+		int nextY = top.pos.y + dy[i];
+		if (!rec.checked(isValid(nextX, nextY)) || visited.get(nextX, nextY)) {
+			continue;
+		}
+
+		if (nextX == target.x && nextY == target.y) {
+			Vector<Position> path;
+			path.push_back(Position(nextX, nextY));
+			for (size_t k = stack.size(); k-- > 0;) {
+				path.push_back(stack[(int)k].pos);
+			}
+			return path;
+		}
+		// 栈中第 k 层对应剩余 jumps - k 跳，走到下一格后还剩 jumps - stack.size() 跳
+		if (jumps - (long long)stack.size() <= 0) {
+			continue;
+		}
+		rec.popped();
+		visited.at(nextX, nextY) = true;
+		stack.push_back({ Position(nextX, nextY), 0 });
+	}
+
+	return Vector<Position>();
+}
+
+/**
+* 使用广度优先搜索算法计算最小跳数。
+*
+* @return 最小跳数
+*/
+int Chessboard::minJumpsBFS() {
+	SearchRecorder rec(stats);
+	rec.reset();
+	if (!isValid(start.x, start.y)) {
+		return -1;
+	}
+	visited.reset();
+
+	Queue<pair<Position, int>> q;
+	q.push({ start, 0 });
+	rec.pushed(q.size());
+	visited.at(start.x, start.y) = true;
+
+	while (!q.empty()) {
+		Position currPos = q.front().first;
+		int currJumps = q.front().second;
+		q.pop();
+		rec.popped();
+
+		if (currPos.x == target.x && currPos.y == target.y) {
+			rec.scratch(visited.allocatedBytes());
+			return currJumps;
+		}
+
+		for (int i = 0; i < 8; i++) {
+			int nextX = currPos.x + dx[i];
+			int nextY = currPos.y + dy[i];
+
+			if (rec.checked(isValid(nextX, nextY)) && !visited.get(nextX, nextY)) {
+				q.push({ Position(nextX, nextY), currJumps + 1 });
+				rec.pushed(q.size());
+				visited.at(nextX, nextY) = true;
+			}
+		}
+	}
+
+	rec.scratch(visited.allocatedBytes());
+	return -1;
+}
+
+/**
+* 无界棋盘上两格之间跳数的下界：每跳横纵坐标各最多变化 2、合计最多变化 3，
+* 且每跳都会改变格子颜色，所以跳数与 |dx| + |dy| 的奇偶性相同。
+*
+* @param offsetX 横坐标差
+* @param offsetY 纵坐标差
+* @return 跳数下界
+*/
+int Chessboard::knightLowerBound(int offsetX, int offsetY) {
+	int a = offsetX < 0 ? -offsetX : offsetX;
+	int b = offsetY < 0 ? -offsetY : offsetY;
+	int bound = std::max(std::max((a + 1) / 2, (b + 1) / 2), (a + b + 2) / 3);
+	if ((bound + a + b) % 2 != 0) {
+		bound++;
+	}
+	return bound;
+}
+
+/**
+* 获取最近一次搜索的统计计数。只有定义了 KNIGHT_SEARCH_STATS 宏时才会计数，否则全部为 0。
+*
+* @return 统计计数
+*/
+const SearchStats& Chessboard::searchStats() const {
+	return stats;
+}
+
+/**
+* 无界棋盘上 3 跳以内可达的偏移量及其跳数，下标为 [|dx|][|dy|]，超过 3 跳记为 -1。
+*/
+static const int SHORT_RANGE = 6;
+static int shortOffsetTable[SHORT_RANGE + 1][SHORT_RANGE + 1];
+
+/**
+* 在以原点为中心的局部网格上做深度为 3 的广度优先搜索，填写 shortOffsetTable。
+*/
+static bool buildShortOffsetTable() {
+	const int side = 4 * SHORT_RANGE + 1;
+	int dist[side][side];
+	for (int i = 0; i < side; i++) {
+		for (int j = 0; j < side; j++) {
+			dist[i][j] = -1;
+		}
+	}
+
+	Queue<Chessboard::Position> q;
+	dist[2 * SHORT_RANGE][2 * SHORT_RANGE] = 0;
+	q.push(Chessboard::Position(2 * SHORT_RANGE, 2 * SHORT_RANGE));
+	while (!q.empty()) {
+		Chessboard::Position curr = q.front();
+		q.pop();
+		if (dist[curr.x][curr.y] == 3) {
+			continue;
+		}
+		for (int i = 0; i < 8; i++) {
+			int nextX = curr.x + Chessboard::dx[i];
+			int nextY = curr.y + Chessboard::dy[i];
+			if (dist[nextX][nextY] == -1) {
+				dist[nextX][nextY] = dist[curr.x][curr.y] + 1;
+				q.push(Chessboard::Position(nextX, nextY));
+			}
+		}
+	}
+
+	for (int i = 0; i <= SHORT_RANGE; i++) {
+		for (int j = 0; j <= SHORT_RANGE; j++) {
+			shortOffsetTable[i][j] = dist[2 * SHORT_RANGE + i][2 * SHORT_RANGE + j];
+		}
+	}
+	return true;
+}
 
-	visited[curr.x][curr.y] = true;
+/**
+* 在棋盘上寻找从 curr 到目标位置恰好 remaining 跳的走法，用跳数下界剪枝。
+* 成功时按终点在前的顺序把经过的位置追加到 path。
+*
+* @param curr 当前位置
+* @param remaining 剩余跳数
+* @param path 路径位置列表
+* @return 找到时返回 true，否则返回 false
+*/
+bool Chessboard::shortWalk(Position curr, int remaining, Vector<Position>& path) {
+	if (remaining == 0) {
+		if (curr.x == target.x && curr.y == target.y) {
+			path.push_back(curr);
+			return true;
+		}
+		return false;
+	}
+	if (knightLowerBound(target.x - curr.x, target.y - curr.y) > remaining) {
+		return false;
+	}
 
+	SearchRecorder rec(stats);
+	rec.popped();
 	for (int i = 0; i < 8; i++) {
 		int nextX = curr.x + dx[i];
 		int nextY = curr.y + dy[i];
 
-		if (isValid(nextX, nextY) && !visited[nextX][nextY]) {
-			Vector<Position> path = backtrack(Position(nextX, nextY), jumps - 1);
-			if (!path.empty()) {
-				path.push_back(curr);
-				return path;
-			}
+		if (rec.checked(isValid(nextX, nextY)) && shortWalk(Position(nextX, nextY), remaining - 1, path)) {
+			path.push_back(curr);
+			return true;
 		}
 	}
-
-	visited[curr.x][curr.y] = false;
-
-	return Vector<Position>();
+	return false;
 }
 
 /**
-* 使用广度优先搜索算法计算最小跳数。
+* 快速预判，在进入搜索之前直接回答平凡的查询：
+* 坐标非法、起点即终点、1 x 1 和 2 x 2 棋盘、3 x 3 棋盘的中心格，
+* 以及无界棋盘上 3 跳以内的查询（查表得到跳数 d 后，在棋盘上依次枚举 d 跳和 d + 2 跳的走法，
+* 靠近边角时 d 跳可能走不通，奇偶性保证不会出现 d + 1 跳）。
 *
-* @return 最小跳数
+* @param path 输出，能回答时为最优路径（不可达时为空）
+* @return 能直接回答时返回 true，需要继续搜索时返回 false
 */
-int Chessboard::minJumpsBFS() {
-	Queue<pair<Position, int>> q;
-	q.push({ start, 0 });
-	visited[start.x][start.y] = true;
+bool Chessboard::quickPath(Vector<Position>& path) {
+	static const bool tableReady = buildShortOffsetTable();
+	(void)tableReady;
+	SearchRecorder(stats).reset();
 
-	while (!q.empty()) {
-		Position currPos = q.front().first;
-		int currJumps = q.front().second;
-		q.pop();
-
-		if (currPos.x == target.x && currPos.y == target.y) {
-			return currJumps;
-		}
+	path = Vector<Position>();
+	if (!isValid(start.x, start.y) || !isValid(target.x, target.y)) {
+		return true;
+	}
+	if (start.x == target.x && start.y == target.y) {
+		path.push_back(start);
+		return true;
+	}
+	if (boardSize <= 2) {
+		return true;
+	}
+	if (boardSize == 3 && ((start.x == 2 && start.y == 2) || (target.x == 2 && target.y == 2))) {
+		return true;
+	}
 
-		for (int i = 0; i < 8; i++) {
-			int nextX = currPos.x + dx[i];
-			int nextY = currPos.y + dy[i];
+	int offsetX = std::abs(target.x - start.x);
+	int offsetY = std::abs(target.y - start.y);
+	if (offsetX > SHORT_RANGE || offsetY > SHORT_RANGE || shortOffsetTable[offsetX][offsetY] < 0) {
+		return false;
+	}
 
-			if (isValid(nextX, nextY) && !visited[nextX][nextY]) {
-				q.push({ Position(nextX, nextY), currJumps + 1 });
-				visited[nextX][nextY] = true;
-			}
+	for (int jumps = shortOffsetTable[offsetX][offsetY]; jumps <= 5; jumps += 2) {
+		if (shortWalk(start, jumps, path)) {
+			return true;
 		}
 	}
+	return false;
+}
 
-	return -1;
+/**
+* 寻找最优路径：先尝试快速预判，无法直接回答时再使用 optimalPathBFS。
+*
+* @return 最优路径的位置列表
+*/
+Vector<Chessboard::Position> Chessboard::shortestPath() {
+	Vector<Position> path;
+	if (quickPath(path)) {
+		return path;
+	}
+	return optimalPathBFS();
+}
+
+/**
+* 打印一次搜索的统计计数。
+*
+* @param stats 统计计数
+*/
+static void printSearchStats(const SearchStats& stats) {
+	cout << "搜索统计: 弹出节点 " << stats.nodesPopped
+		<< "，生成相邻格子 " << stats.neighboursGenerated
+		<< "，越界 " << stats.invalidRejections
+		<< "，队列最大长度 " << stats.maxQueueSize
+		<< "，网格内存峰值 " << stats.peakScratchBytes << " 字节"
+		<< "，分配次数 " << stats.allocations << '\n';
+}
+
+/**
+* 打印一段代码的堆分配情况。
+*
+* @param scope 包围该段代码的 AllocationScope
+*/
+static void printAllocations(const AllocationScope& scope) {
+	cout << "堆分配: 次数 " << scope.allocations()
+		<< "，请求 " << scope.bytes() << " 字节"
+		<< "，占用峰值 " << scope.peakBytes() << " 字节" << '\n';
 }
 
 void Chessboard::solve() {
+	// 控制台输出先收集到大块缓冲区中，打开图像窗口前和函数结束时才整块写出
+	OutputSink console(cout, asyncOutput);
 	readInputFromFile();
 	ofstream outputFile("output.txt");
 
+	// 近距离或小棋盘的查询由快速预判直接回答，不再运行各个搜索函数
+	AllocationScope quickAllocations;
+	auto startQuick = chrono::high_resolution_clock::now();
+	Vector<Position> quick;
+	bool answered = quickPath(quick);
+	auto endQuick = chrono::high_resolution_clock::now();
+	if (answered) {
+		chrono::duration<double> durationQuick = endQuick - startQuick;
+		cout << "快速预判函数 quickPath() 运行时间: " << durationQuick.count() << " 秒" << '\n';
+		SearchStats quickStats = stats;
+		if (SEARCH_STATS_ENABLED) {
+			printSearchStats(quickStats);
+		}
+		if (ALLOCATION_TRACKING_ENABLED) {
+			printAllocations(quickAllocations);
+		}
+		writeText(quick, outputFile);
+		printPath(quick);
+		printJsonFast(quick, SEARCH_STATS_ENABLED ? &quickStats : nullptr);
+		console.flush();
+		displayPath(quick);
+		outputFile.close();
+		return;
+	}
+
 	// 测量 optimalPathBFS() 函数的运行时间
+	AllocationScope bfsAllocations;
 	auto startBFS = chrono::high_resolution_clock::now();
 	Vector<Position> path = optimalPathBFS();
 	auto endBFS = chrono::high_resolution_clock::now();
 	chrono::duration<double> durationBFS = endBFS - startBFS;
-	cout << "寻找最优解函数 optimalPathBFS() 运行时间: " << durationBFS.count() << " 秒" << endl;
-	outputFile << path.size() - 1 << endl;
+	cout << "寻找最优解函数 optimalPathBFS() 运行时间: " << durationBFS.count() << " 秒" << '\n';
+	SearchStats bfsStats = stats;
+	if (SEARCH_STATS_ENABLED) {
+		printSearchStats(bfsStats);
+	}
+	if (ALLOCATION_TRACKING_ENABLED) {
+		printAllocations(bfsAllocations);
+	}
+	writeText(path, outputFile);
 	printPath(path);
 
 	// 测量 branchBoundPath() 函数的运行时间
+	AllocationScope bbAllocations;
 	auto startBB = chrono::high_resolution_clock::now();
 	Vector<Position> path2 = branchBoundPath();
 	auto endBB = chrono::high_resolution_clock::now();
 	chrono::duration<double> durationBB = endBB - startBB;
-	cout << "寻找最优解函数 branchBoundPath() 运行时间: " << durationBB.count() << " 秒" << endl;
+	cout << "寻找最优解函数 branchBoundPath() 运行时间: " << durationBB.count() << " 秒" << '\n';
+	if (SEARCH_STATS_ENABLED) {
+		printSearchStats(stats);
+	}
+	if (ALLOCATION_TRACKING_ENABLED) {
+		printAllocations(bbAllocations);
+	}
 	printPath(path2);
-	printJson(path);
+	printJsonFast(path, SEARCH_STATS_ENABLED ? &bfsStats : nullptr);
+	console.flush();
 	displayPath(path);
 
 	// 测量 feasiblePathDFS() 函数的运行时间
+	AllocationScope dfsAllocations;
 	auto startDFS = chrono::high_resolution_clock::now();
 	Vector<Position> path3 = feasiblePathDFS();
 	auto endDFS = chrono::high_resolution_clock::now();
 	chrono::duration<double> durationDFS = endDFS - startDFS;
-	cout << "寻找可行解函数 feasiblePathDFS() 运行时间: " << durationDFS.count() << " 秒" << endl;
+	cout << "寻找可行解函数 feasiblePathDFS() 运行时间: " << durationDFS.count() << " 秒" << '\n';
+	if (SEARCH_STATS_ENABLED) {
+		printSearchStats(stats);
+	}
+	if (ALLOCATION_TRACKING_ENABLED) {
+		printAllocations(dfsAllocations);
+	}
 	printPath(path3);
 
 	outputFile.close();
@@ -276,6 +1146,98 @@ void Chessboard::printChessboard(const Position& start, const Position& target,
 	cout << endl;
 }
 
+/**
+* 以流式方式打印棋盘，输出格式与 printChessboard 相同。
+* 不构造 N x N 的棋盘数组：路径格子按 (行, 列) 排序后逐行合并到空白行模板中，
+* 所有输出先写入大块缓冲区再整体写出，额外内存为 O(N + 路径长度)。
+*
+* @param start 起始位置
+* @param target 目标位置
+* @param path 路径位置列表
+* @param out 输出流
+*/
+void Chessboard::renderChessboard(const Position& start, const Position& target, const Vector<Position>& path, ostream& out) {
+	TextBuffer buffer(out);
+	renderChessboard(start, target, path, buffer);
+}
+
+/**
+* 把棋盘追加到文本缓冲区中，便于与路径信息一起整块写出。
+*
+* @param start 起始位置
+* @param target 目标位置
+* @param path 路径位置列表
+* @param buffer 文本缓冲区
+*/
+void Chessboard::renderChessboard(const Position& start, const Position& target, const Vector<Position>& path, TextBuffer& buffer) {
+	struct CellMark {
+		int x;
+		int y;
+		int kind; // 0 起点，1 终点，2 路径格子，同一格子按此顺序取第一个
+		int step;
+	};
+
+	Vector<CellMark> marks;
+	marks.push_back({ start.x, start.y, 0, 0 });
+	marks.push_back({ target.x, target.y, 1, 0 });
+	for (int i = 0; i < path.size(); i++) {
+		marks.push_back({ path[i].x, path[i].y, 2, (int)path.size() - i - 1 });
+	}
+	sort(marks.begin(), marks.end(), [](const CellMark& a, const CellMark& b) {
+		if (a.x != b.x) return a.x < b.x;
+		if (a.y != b.y) return a.y < b.y;
+		return a.kind < b.kind;
+	});
+
+	// 分隔行 "+--+--+...+" 与空白行 "|  |  |...|" 只构造一次，逐行复用
+	size_t lineLength = 3 * (size_t)boardSize + 2;
+	Vector<char> border(lineLength, '-');
+	Vector<char> blank(lineLength, ' ');
+	for (size_t k = 0; k < lineLength - 1; k += 3) {
+		border[(int)k] = '+';
+		blank[(int)k] = '|';
+	}
+	border[(int)lineLength - 1] = '\n';
+	blank[(int)lineLength - 1] = '\n';
+
+	buffer.append(border.begin(), lineLength);
+
+	int m = 0;
+	for (int i = 1; i <= boardSize; i++) {
+		while (m < marks.size() && marks[m].x < i) {
+			m++;
+		}
+
+		buffer.appendChar('|');
+		size_t emitted = 1; // 空白行模板中已输出到的位置
+		int nextCol = 1;
+		for (; m < marks.size() && marks[m].x == i; m++) {
+			const CellMark& mark = marks[m];
+			if (mark.y < nextCol || mark.y > boardSize) {
+				continue;
+			}
+
+			size_t cellBegin = 1 + 3 * (size_t)(mark.y - 1);
+			buffer.append(blank.begin() + emitted, cellBegin - emitted);
+			if (mark.kind == 0) {
+				buffer.append(" S", 2);
+			} else if (mark.kind == 1) {
+				buffer.append(" T", 2);
+			} else if (mark.step == 0) {
+				buffer.append("  ", 2);
+			} else {
+				buffer.appendPadded(mark.step, 2);
+			}
+			buffer.appendChar('|');
+			emitted = cellBegin + 3;
+			nextCol = mark.y + 1;
+		}
+		buffer.append(blank.begin() + emitted, lineLength - emitted);
+		buffer.append(border.begin(), lineLength);
+	}
+	buffer.appendChar('\n');
+}
+
 /**
 * 打印路径的 JSON 格式。
 *
@@ -305,11 +1267,228 @@ void Chessboard::printJson(Vector<Position> path) {
 }
 
 /**
-* 在图像窗口中展示路径。
+* 直接以流式方式写出路径的 JSON，不构造 nlohmann::json 对象树。
+* 输出与 printJson 中 result.dump() 的结果逐字节相同（键按字母序排列、无空白）。
+*
+* @param path 路径位置列表
+* @param out 输出流
+* @param pathStats 不为空时额外写出 "stats" 字段，内容为求得该路径的搜索统计
+*/
+void Chessboard::writeJson(const Vector<Position>& path, ostream& out, const SearchStats* pathStats) {
+	TextBuffer buffer(out);
+	writeJson(path, buffer, pathStats);
+}
+
+/**
+* 把路径的 JSON 追加到已有的文本缓冲区，批量写出多条结果时共用同一个缓冲区。
+*
+* @param path 路径位置列表
+* @param buffer 文本缓冲区
+* @param pathStats 不为空时额外写出 "stats" 字段
+*/
+void Chessboard::writeJson(const Vector<Position>& path, TextBuffer& buffer, const SearchStats* pathStats) {
+	buffer.append("{\"boardSize\":");
+	buffer.appendInt(boardSize);
+	buffer.append(",\"minJumps\":");
+	buffer.appendInt((long long)path.size() - 1);
+	buffer.append(",\"path\":[");
+	for (int i = path.size() - 1; i >= 0; i--) {
+		buffer.append("{\"x\":", 5);
+		buffer.appendInt(path[i].x);
+		buffer.append(",\"y\":", 5);
+		buffer.appendInt(path[i].y);
+		buffer.appendChar('}');
+		if (i != 0) {
+			buffer.appendChar(',');
+		}
+	}
+	buffer.append("],\"start\":{\"x\":");
+	buffer.appendInt(start.x);
+	buffer.append(",\"y\":");
+	buffer.appendInt(start.y);
+	if (pathStats != nullptr) {
+		buffer.append("},\"stats\":{\"allocations\":");
+		buffer.appendInt((long long)pathStats->allocations);
+		buffer.append(",\"invalidRejections\":");
+		buffer.appendInt((long long)pathStats->invalidRejections);
+		buffer.append(",\"maxQueueSize\":");
+		buffer.appendInt((long long)pathStats->maxQueueSize);
+		buffer.append(",\"neighboursGenerated\":");
+		buffer.appendInt((long long)pathStats->neighboursGenerated);
+		buffer.append(",\"nodesPopped\":");
+		buffer.appendInt((long long)pathStats->nodesPopped);
+		buffer.append(",\"peakScratchBytes\":");
+		buffer.appendInt((long long)pathStats->peakScratchBytes);
+	}
+	buffer.append("},\"target\":{\"x\":");
+	buffer.appendInt(target.x);
+	buffer.append(",\"y\":");
+	buffer.appendInt(target.y);
+	buffer.append("}}");
+}
+
+/**
+* 打印路径的 JSON 格式，使用 writeJson 直接写出到控制台和 output.json。
+*
+* @param path 路径位置列表
+* @param pathStats 不为空时在 JSON 中附带搜索统计
+*/
+void Chessboard::printJsonFast(const Vector<Position>& path, const SearchStats* pathStats) {
+	ofstream outputJson("output.json");
+	if (path.empty()) {
+		cout << "没有找到路径.\n";
+	} else {
+		cout << "转换最短路径为JSON格式为: \n";
+		writeJson(path, cout, pathStats);
+		cout << "\n\n";
+		writeJson(path, outputJson, pathStats);
+		outputJson << '\n';
+	}
+	outputJson.close();
+}
+
+/**
+* 以二进制格式保存路径，每跳只占 3 位（格式见 BinaryFormat.h）。
+*
+* @param path 路径位置列表（与各求解函数的返回值相同，终点在前）
+* @param fileName 输出文件名
+* @return 写入成功返回 true，否则返回 false
+*/
+bool Chessboard::writeBinaryPath(const Vector<Position>& path, const char* fileName) {
+	ofstream outputFile(fileName, ios::binary);
+	if (!outputFile.is_open()) {
+		return false;
+	}
+	return writeBinaryPath(path, outputFile);
+}
+
+/**
+* 把路径以二进制格式写入输出流。多条路径可以依次写入同一个流，每条记录都以自己的文件头开始。
+* 先打包并校验所有跳步，路径中有不合法的跳步时什么也不写，不会在流中留下没有负载的文件头。
+*
+* @param path 路径位置列表
+* @param outputFile 以二进制方式打开的输出流
+* @return 写入成功返回 true，否则返回 false
+*/
+bool Chessboard::writeBinaryPath(const Vector<Position>& path, ostream& outputFile) {
+	uint32_t jumps = path.empty() ? BINARY_NO_PATH : (uint32_t)path.size() - 1;
+	Vector<unsigned char> packed(path.empty() ? 0 : ((size_t)jumps * 3 + 7) / 8, 0);
+	size_t bit = 0;
+	for (int k = path.size() - 1; k > 0; k--) {
+		int moveX = path[k - 1].x - path[k].x;
+		int moveY = path[k - 1].y - path[k].y;
+		int move = 0;
+		while (move < 8 && !(dx[move] == moveX && dy[move] == moveY)) {
+			move++;
+		}
+		if (move == 8) {
+			return false;
+		}
+		for (int b = 0; b < 3; b++, bit++) {
+			if (move & (1 << b)) {
+				packed.begin()[bit >> 3] |= (unsigned char)(1 << (bit & 7));
+			}
+		}
+	}
+
+	BinaryHeader header = makeBinaryHeader(BINARY_KIND_PATH, boardSize, start.x, start.y, target.x, target.y, jumps);
+	outputFile.write((const char*)&header, sizeof(header));
+	if (!packed.empty()) {
+		outputFile.write((const char*)packed.begin(), packed.size());
+	}
+	return outputFile.good();
+}
+
+/**
+* 以二进制格式保存距离场。负载直接从 distanceField 返回的缓冲区写出，不做任何转换。
+*
+* @param field distanceField 返回的距离场
+* @param fileName 输出文件名
+* @return 写入成功返回 true，否则返回 false
+*/
+bool Chessboard::writeBinaryDistanceMap(const Vector<unsigned short>& field, const char* fileName) {
+	if (field.size() != (size_t)boardSize * boardSize) {
+		return false;
+	}
+	ofstream outputFile(fileName, ios::binary);
+	if (!outputFile.is_open()) {
+		return false;
+	}
+
+	BinaryHeader header = makeBinaryHeader(BINARY_KIND_DISTANCE_MAP, boardSize, start.x, start.y, target.x, target.y, (uint32_t)field.size());
+	outputFile.write((const char*)&header, sizeof(header));
+	outputFile.write((const char*)field.begin(), field.size() * sizeof(unsigned short));
+	return outputFile.good();
+}
+
+/**
+* 通过内存映射读取 writeBinaryPath 保存的路径。
+*
+* @param fileName 输入文件名
+* @return 路径位置列表（终点在前），文件无效或不可达时返回空列表
+*/
+Vector<Chessboard::Position> Chessboard::readBinaryPath(const char* fileName) {
+	MappedFile file;
+	if (!file.open(fileName)) {
+		return Vector<Position>();
+	}
+	const BinaryHeader* header = binaryHeader(file.data(), file.size(), BINARY_KIND_PATH);
+	if (header == nullptr || header->count == BINARY_NO_PATH) {
+		return Vector<Position>();
+	}
+
+	const unsigned char* packed = (const unsigned char*)(file.data() + sizeof(BinaryHeader));
+	Vector<Position> forward;
+	Position curr(header->startX, header->startY);
+	forward.push_back(curr);
+	size_t bit = 0;
+	for (uint32_t k = 0; k < header->count; k++) {
+		int move = 0;
+		for (int b = 0; b < 3; b++, bit++) {
+			move |= ((packed[bit >> 3] >> (bit & 7)) & 1) << b;
+		}
+		curr = Position(curr.x + dx[move], curr.y + dy[move]);
+		forward.push_back(curr);
+	}
+
+	Vector<Position> path;
+	for (int k = forward.size() - 1; k >= 0; k--) {
+		path.push_back(forward[k]);
+	}
+	return path;
+}
+
+/**
+* 设置是否在图像窗口中展示路径。关闭后 displayPath 直接返回，不创建窗口，也不会阻塞在 waitKey 上。
+*
+* @param enabled 是否展示
+*/
+void Chessboard::setDisplayEnabled(bool enabled) {
+	displayEnabled = enabled;
+}
+
+/**
+* 设置 solve 的控制台输出是否由后台线程写出（见 OutputSink）。两种方式输出的内容相同。
+*
+* @param enabled 是否异步写出
+*/
+void Chessboard::setAsyncOutput(bool enabled) {
+	asyncOutput = enabled;
+}
+
+/**
+* 在图像窗口中展示路径。定义 KNIGHT_HEADLESS 编译时不依赖 OpenCV，本函数什么也不做。
 *
 * @param path 路径位置列表
 */
 void Chessboard::displayPath(Vector<Position>& path) {
+#ifdef KNIGHT_HEADLESS
+	(void)path;
+#else
+	if (!displayEnabled) {
+		return;
+	}
+
 	const int Size = 15;  // 棋盘格子的大小
 	const int Menu = Size / 2;  // 路径线的宽度
 
@@ -381,45 +1560,236 @@ void Chessboard::displayPath(Vector<Position>& path) {
 
 	imshow("ChessBoard", img);
 	waitKey(0);
+#endif
+}
+
+/**
+* 计算导出图像的缩放：每个像素块代表 cellsPerBlock x cellsPerBlock 个格子，边长 blockSize 像素。
+* 棋盘边长乘以 cellSize 不超过 maxImageSize 时不缩放；否则先缩小格子，仍然放不下时再合并格子。
+*
+* @param cellSize 期望的格子边长（像素）
+* @param maxImageSize 图像边长上限（像素）
+* @param cellsPerBlock 输出，每个像素块的边长（格子数）
+* @param blockSize 输出，每个像素块的边长（像素）
+*/
+void Chessboard::imageScale(int cellSize, int maxImageSize, int& cellsPerBlock, int& blockSize) const {
+	if (cellSize < 1) {
+		cellSize = 1;
+	}
+	if (maxImageSize < 1) {
+		maxImageSize = 1;
+	}
+	cellsPerBlock = 1;
+	blockSize = cellSize;
+	if ((long long)boardSize * cellSize > maxImageSize) {
+		blockSize = std::max(maxImageSize / boardSize, 1);
+		cellsPerBlock = (boardSize + maxImageSize - 1) / maxImageSize;
+	}
+}
+
+/**
+* 不打开窗口，把路径直接绘制成 PNG 或 PPM 图像文件（按扩展名选择，见 RasterImage::write）。
+* 颜色与 displayPath 相同：路径格子为黄色，起点为蓝色，终点为红色，格子较大时画出网格线和路径折线。
+*
+* 棋盘边长乘以 cellSize 超过 maxImageSize 时自动缩小：先把每个格子缩到 maxImageSize / boardSize 像素，
+* 棋盘比 maxImageSize 还大时再把相邻的若干格子合并成一个像素，图像边长始终不超过 maxImageSize。
+* 除了填充背景和网格线，只绘制路径上的格子，不遍历整张棋盘。
+*
+* @param path 路径位置列表
+* @param fileName 输出文件名
+* @param cellSize 每个格子的边长（像素）
+* @param maxImageSize 图像边长上限（像素）
+* @return 写入成功返回 true，否则返回 false
+*/
+bool Chessboard::exportPathImage(const Vector<Position>& path, const char* fileName, int cellSize, int maxImageSize) {
+	int cellsPerBlock, blockSize;
+	imageScale(cellSize, maxImageSize, cellsPerBlock, blockSize);
+	int blocks = (boardSize + cellsPerBlock - 1) / cellsPerBlock;
+	RasterImage image(blocks * blockSize, blocks * blockSize);
+
+	if (blockSize >= 6) {
+		for (int k = 1; k < blocks; k++) {
+			image.fillRect(k * blockSize, 0, 1, image.height(), 238, 238, 141);
+			image.fillRect(0, k * blockSize, image.width(), 1, 238, 238, 141);
+		}
+	}
+
+	// 横坐标对应图像的行，纵坐标对应图像的列，与 displayPath 一致
+	for (int i = 0; i < path.size(); i++) {
+		int row = (path[i].x - 1) / cellsPerBlock;
+		int col = (path[i].y - 1) / cellsPerBlock;
+		image.fillRect(col * blockSize, row * blockSize, blockSize, blockSize, 255, 255, 0);
+	}
+	if (isValid(start.x, start.y)) {
+		image.fillRect((start.y - 1) / cellsPerBlock * blockSize, (start.x - 1) / cellsPerBlock * blockSize, blockSize, blockSize, 0, 0, 255);
+	}
+	if (isValid(target.x, target.y)) {
+		image.fillRect((target.y - 1) / cellsPerBlock * blockSize, (target.x - 1) / cellsPerBlock * blockSize, blockSize, blockSize, 255, 0, 0);
+	}
+
+	if (blockSize >= 4) {
+		int half = blockSize / 2;
+		for (int i = 1; i < path.size(); i++) {
+			image.drawLine((path[i - 1].y - 1) / cellsPerBlock * blockSize + half, (path[i - 1].x - 1) / cellsPerBlock * blockSize + half,
+				(path[i].y - 1) / cellsPerBlock * blockSize + half, (path[i].x - 1) / cellsPerBlock * blockSize + half, 0, 0, 0);
+		}
+	}
+
+	return image.write(fileName);
+}
+
+/**
+* 热力图调色板的锚点颜色，距离从 0 到最大值依次经过蓝、青、绿、黄、红。
+*/
+static const unsigned char HEATMAP_ANCHORS[5][3] = {
+	{ 0, 0, 255 }, { 0, 255, 255 }, { 0, 255, 0 }, { 255, 255, 0 }, { 255, 0, 0 }
+};
+
+/**
+* 把距离场导出为热力图（PNG 或 PPM，按扩展名选择），未到达的格子为黑色。
+* 距离场可以来自 distanceField()（与 optimalPathBFS 搜索的是同一张图），按 cellIndex 排列。
+*
+* 先扫描一遍求最大距离并建立 距离 -> 颜色 的查找表，再逐行把连续的距离缓冲区映射为像素行，
+* 一个像素块行只生成一次，其余像素行直接复制，不对单个格子调用任何绘图函数。
+* 缩放规则与 exportPathImage 相同；合并格子时每个像素块取块内左上角格子的距离。
+*
+* @param field 距离场
+* @param fileName 输出文件名
+* @param cellSize 每个格子的边长（像素）
+* @param maxImageSize 图像边长上限（像素）
+* @return 写入成功返回 true，距离场大小不符或写入失败返回 false
+*/
+bool Chessboard::exportDistanceHeatmap(const Vector<unsigned short>& field, const char* fileName, int cellSize, int maxImageSize) {
+	if (field.size() != (size_t)boardSize * boardSize) {
+		return false;
+	}
+	const unsigned short* dist = field.begin();
+
+	unsigned short maxDist = 0;
+	for (size_t i = 0; i < field.size(); i++) {
+		if (dist[i] != UNREACHED && dist[i] > maxDist) {
+			maxDist = dist[i];
+		}
+	}
+
+	// 查找表覆盖 0..maxDist，UNREACHED 不查表，保留背景的黑色
+	Vector<unsigned char> lut(((size_t)maxDist + 1) * 3, 0);
+	unsigned char* colors = lut.begin();
+	for (int d = 0; d <= maxDist; d++) {
+		double t = maxDist == 0 ? 0.0 : (double)d * 4 / maxDist;
+		int segment = std::min((int)t, 3);
+		double frac = t - segment;
+		for (int c = 0; c < 3; c++) {
+			colors[d * 3 + c] = (unsigned char)(HEATMAP_ANCHORS[segment][c] + (HEATMAP_ANCHORS[segment + 1][c] - HEATMAP_ANCHORS[segment][c]) * frac + 0.5);
+		}
+	}
+
+	int cellsPerBlock, blockSize;
+	imageScale(cellSize, maxImageSize, cellsPerBlock, blockSize);
+	int blocks = (boardSize + cellsPerBlock - 1) / cellsPerBlock;
+	RasterImage image(blocks * blockSize, blocks * blockSize, 0, 0, 0);
+	unsigned char* pixels = image.data();
+	size_t rowBytes = (size_t)image.width() * 3;
+
+	for (int blockRow = 0; blockRow < blocks; blockRow++) {
+		const unsigned short* cells = dist + (size_t)blockRow * cellsPerBlock * boardSize;
+		unsigned char* first = pixels + (size_t)blockRow * blockSize * rowBytes;
+		unsigned char* px = first;
+		for (int blockCol = 0; blockCol < blocks; blockCol++) {
+			unsigned short d = cells[(size_t)blockCol * cellsPerBlock];
+			if (d != UNREACHED) {
+				const unsigned char* color = colors + (size_t)d * 3;
+				for (int k = 0; k < blockSize; k++) {
+					px[0] = color[0];
+					px[1] = color[1];
+					px[2] = color[2];
+					px += 3;
+				}
+			} else {
+				px += (size_t)blockSize * 3;
+			}
+		}
+		for (int k = 1; k < blockSize; k++) {
+			memcpy(first + k * rowBytes, first, rowBytes);
+		}
+	}
+
+	return image.write(fileName);
 }
 
 /**
 * 在图像窗口中展示路径。
 */
 void Chessboard::readInputFromFile() {
-	ifstream inputFile("input.txt");
-	if (!inputFile.is_open()) {
-		cout << "无法打开输入文件" << endl;
+	QueryReader reader;
+	if (!reader.open("input.txt")) {
+		cout << "无法打开输入文件\n";
 		return;
 	}
 
-	// 读取输入数据的逻辑
-	int startX, startY, targetX, targetY;
-	inputFile >> startX >> startY >> targetX >> targetY;
-	start = Position(startX, startY);
-	target = Position(targetX, targetY);
-
-	inputFile.close();
+	// 读取输入数据的逻辑，只使用文件中的第一个查询
+	Query query;
+	if (reader.next(query)) {
+		start = query.start;
+		target = query.target;
+	} else if (reader.failed()) {
+		cout << "输入文件第 " << reader.errorLine() << " 行无法解析\n";
+	}
 }
 
 /**
-* 打印路径的详细信息，包括跳数和位置坐标。
+* 打印路径的详细信息，包括跳数、位置坐标和棋盘。整条结果先写入一个缓冲区，再一次写入 cout。
 *
 * @param path 路径位置列表
 */
 void Chessboard::printPath(Vector<Position> path) {
+	TextBuffer buffer(cout);
 	if (path.empty()) {
-		cout << "没有找到路径." << endl;
-	} else {
-		cout << "跳数: " << path.size() - 1 << endl;
-		cout << "路径: ";
-		for (int i = path.size() - 1; i >= 0; i--) {
-			cout << "(" << path[i].x << ", " << path[i].y << ")";
-			if (i != 0) {
-				cout << " -> ";
-			}
-		}
-		cout << endl;
-		printChessboard(start, target, path);
+		buffer.append("没有找到路径.\n");
+		return;
+	}
+	buffer.append("跳数: ");
+	buffer.appendInt(path.size() - 1);
+	buffer.append("\n路径: ");
+	const Position* cells = path.begin();
+	for (size_t i = path.size(); i-- > 0;) {
+		buffer.appendChar('(');
+		buffer.appendInt(cells[i].x);
+		buffer.append(", ");
+		buffer.appendInt(cells[i].y);
+		buffer.append(i != 0 ? ") -> " : ")\n");
+	}
+	renderChessboard(start, target, path, buffer);
+}
+
+/**
+* 以 output.txt 的格式写出一条结果：跳数一行，路径一行（从起点到终点），不可达时跳数为 -1、路径为空。
+*
+* @param path 路径位置列表（终点在前）
+* @param out 输出流
+*/
+void Chessboard::writeText(const Vector<Position>& path, ostream& out) {
+	TextBuffer buffer(out);
+	writeText(path, buffer);
+}
+
+/**
+* 以 output.txt 的格式把一条结果追加到文本缓冲区中。
+*
+* @param path 路径位置列表（终点在前）
+* @param buffer 文本缓冲区
+*/
+void Chessboard::writeText(const Vector<Position>& path, TextBuffer& buffer) {
+	buffer.append("Minimum Jumps: ");
+	buffer.appendInt((long long)path.size() - 1);
+	buffer.append("\nPath:");
+	const Position* cells = path.begin();
+	for (size_t i = path.size(); i-- > 0;) {
+		buffer.append(i + 1 == path.size() ? " (" : " -> (");
+		buffer.appendInt(cells[i].x);
+		buffer.append(", ");
+		buffer.appendInt(cells[i].y);
+		buffer.appendChar(')');
 	}
+	buffer.appendChar('\n');
 }
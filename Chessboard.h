@@ -1,6 +1,12 @@
 ﻿#pragma once
+#include <iosfwd>
 #include "Vector.h"
 #include "Queue.h"
+#include "TiledGrid.h"
+#include "StampedGrid.h"
+#include "SearchStats.h"
+
+class TextBuffer;
 
 class Chessboard {
 public:
@@ -11,30 +17,91 @@ public:
 		Position(int _x, int _y) : x(_x), y(_y) {}
 	};
 
+	static const unsigned short UNREACHED = 0xFFFF; // 距离场中未到达格子的标记
+	static const unsigned long long GRID_MEMORY_BUDGET = 1ULL << 30; // 整盘暂存网格允许占用的内存（字节）
+	static const int MAX_BOARD_SIZE = 8192; // 查询文件和命令行允许的最大棋盘大小，使整盘暂存网格不超过 GRID_MEMORY_BUDGET
+	static const int dx[8]; // 马的 8 种走法的横坐标增量
+	static const int dy[8]; // 马的 8 种走法的纵坐标增量
+
 private:
+	struct SearchCell {
+		int jumps; // 从起点到该格子的跳数
+		Position parent; // 搜索树中的父节点
+	};
+
+	// StampedGrid<SearchCell> 每格另有 4 字节的代数；MAX_BOARD_SIZE 取预算内能容纳的最大棋盘
+	static_assert((unsigned long long)MAX_BOARD_SIZE * MAX_BOARD_SIZE * (sizeof(unsigned int) + sizeof(SearchCell)) <= GRID_MEMORY_BUDGET
+		&& (unsigned long long)(MAX_BOARD_SIZE + 1) * (MAX_BOARD_SIZE + 1) * (sizeof(unsigned int) + sizeof(SearchCell)) > GRID_MEMORY_BUDGET,
+		"MAX_BOARD_SIZE 与 GRID_MEMORY_BUDGET 不一致");
+
 	int boardSize;
 	int currJumps;
-	const int dx[8] = { 1, 2, 2, 1, -1, -2, -2, -1 };
-	const int dy[8] = { 2, 1, -1, -2, -2, -1, 1, 2 };
-	Vector<Vector<bool>> visited;
+	TiledGrid<bool> visited; // 深度优先搜索和 minJumpsBFS 的已访问标记，按块惰性分配
+	StampedGrid<SearchCell> scratch; // optimalPathBFS、branchBoundPath 和 astarPath 跨查询复用的暂存网格
 	Position start;
 	Position target;
+	size_t sourceCacheCapacity; // 按起点缓存的距离场个数上限
+	size_t sourceCacheNext; // 缓存满时下一个被替换的位置
+	Vector<int> sourceCacheKeys; // 缓存的距离场对应的基本区域起点编号
+	Vector<Vector<unsigned short>> sourceCacheFields; // 缓存的距离场
+	SearchStats stats; // 最近一次搜索的统计计数（定义 KNIGHT_SEARCH_STATS 时才计数）
+	bool displayEnabled; // displayPath 是否打开图像窗口
+	bool asyncOutput; // solve 的控制台输出是否由后台线程写出
 
 public:
 	Chessboard();
 	Chessboard(int boardSize_);
+	int size() const;
 	bool isValid(int x, int y);
+	void setQuery(const Position& start_, const Position& target_);
 	Vector<Position> optimalPathBFS();
+	Vector<Position> optimalPathLayeredBFS(bool packedLayers = false);
+	Vector<unsigned short> distanceField(bool stopAtTarget = false);
+	Vector<unsigned short> distanceField(const Position& source, const Position& stopAt);
+	Vector<Position> symmetricPathBFS();
+	int symmetricMinJumps();
+	void setSourceCacheCapacity(size_t capacity);
+	Vector<Position> nearestPathBFS(const Vector<Position>& sources, const Vector<Position>& targets, int& sourceIndex, int& targetIndex);
 	Vector<Position> branchBoundPath();
+	Vector<Position> astarPath();
 	Vector<Position> feasiblePathDFS();
 	Vector<Position> backtrack(Position curr, int jumps);
 	int minJumpsBFS();
+	bool quickPath(Vector<Position>& path);
+	Vector<Position> shortestPath();
+	static int knightLowerBound(int offsetX, int offsetY);
+	const SearchStats& searchStats() const;
 	void solve();
 	void printChessboard(const Position& start, const Position& target, const Vector<Position>& path);
+	void renderChessboard(const Position& start, const Position& target, const Vector<Position>& path, std::ostream& out);
+	void renderChessboard(const Position& start, const Position& target, const Vector<Position>& path, TextBuffer& buffer);
 	void printPath(Vector<Position> path);
+	static void writeText(const Vector<Position>& path, std::ostream& out);
+	static void writeText(const Vector<Position>& path, TextBuffer& buffer);
+	void setDisplayEnabled(bool enabled);
+	void setAsyncOutput(bool enabled);
 	void displayPath(Vector<Position>& path);
+	bool exportPathImage(const Vector<Position>& path, const char* fileName, int cellSize = 15, int maxImageSize = 4096);
+	bool exportDistanceHeatmap(const Vector<unsigned short>& field, const char* fileName, int cellSize = 1, int maxImageSize = 4096);
 	void printJson(Vector<Position> path);
+	void printJsonFast(const Vector<Position>& path, const SearchStats* pathStats = nullptr);
+	void writeJson(const Vector<Position>& path, std::ostream& out, const SearchStats* pathStats = nullptr);
+	void writeJson(const Vector<Position>& path, TextBuffer& buffer, const SearchStats* pathStats = nullptr);
+	bool writeBinaryPath(const Vector<Position>& path, const char* fileName);
+	bool writeBinaryPath(const Vector<Position>& path, std::ostream& out);
+	bool writeBinaryDistanceMap(const Vector<unsigned short>& field, const char* fileName);
+	Vector<Position> readBinaryPath(const char* fileName);
 	void readInputFromFile();
+
+private:
+	size_t cellIndex(int x, int y) const;
+	void imageScale(int cellSize, int maxImageSize, int& cellsPerBlock, int& blockSize) const;
+	Vector<unsigned short> distanceFieldFrom(const Position& source, const Position* stopAt);
+	const unsigned short* findCachedField(const Position& canonicalSource);
+	const unsigned short* cachedField(const Position& canonicalSource);
+	int canonicalQuery(Position& source, Position& dest, bool& reversed);
+	Vector<Position> packedLayerPath();
+	bool shortWalk(Position curr, int remaining, Vector<Position>& path);
 };
 
 
@@ -0,0 +1,120 @@
+﻿#include <fstream>
+
+#include "DistanceTable.h"
+#include "BinaryFormat.h"
+#include "Symmetry.h"
+
+using namespace std;
+
+typedef Chessboard::Position Position;
+
+const unsigned char DistanceTable::UNREACHABLE;
+const int DistanceTable::MAX_BOARD_SIZE;
+
+DistanceTable::DistanceTable() : table(nullptr), boardSize(0) {}
+
+bool DistanceTable::build(int boardSize_, const char* fileName) {
+	if (boardSize_ < 1 || boardSize_ > MAX_BOARD_SIZE) {
+		return false;
+	}
+	ofstream outputFile(fileName, ios::binary);
+	if (!outputFile.is_open()) {
+		return false;
+	}
+
+	int sources = canonicalCount(boardSize_);
+	BinaryHeader header = makeBinaryHeader(BINARY_KIND_DISTANCE_TABLE, boardSize_, 0, 0, 0, 0, (uint32_t)sources);
+	outputFile.write((const char*)&header, sizeof(header));
+
+	// 按 canonicalIndex 的顺序逐个计算基本区域内起点的距离场
+	size_t cells = (size_t)boardSize_ * boardSize_;
+	Chessboard chessboard(boardSize_);
+	Vector<unsigned char> row(cells, UNREACHABLE);
+	int half = (boardSize_ + 1) / 2;
+	for (int x = 1; x <= half; x++) {
+		for (int y = x; y <= half; y++) {
+			chessboard.setQuery(Position(x, y), Position(x, y));
+			Vector<unsigned short> field = chessboard.distanceField();
+			const unsigned short* dist = field.begin();
+			unsigned char* out = row.begin();
+			for (size_t k = 0; k < cells; k++) {
+				out[k] = dist[k] == Chessboard::UNREACHED ? UNREACHABLE : (unsigned char)dist[k];
+			}
+			outputFile.write((const char*)out, cells);
+		}
+	}
+
+	return outputFile.good();
+}
+
+bool DistanceTable::open(const char* fileName) {
+	table = nullptr;
+	boardSize = 0;
+	if (!file.open(fileName)) {
+		return false;
+	}
+
+	const BinaryHeader* header = binaryHeader(file.data(), file.size(), BINARY_KIND_DISTANCE_TABLE);
+	if (header == nullptr || (int)header->count != canonicalCount((int)header->boardSize)) {
+		file.close();
+		return false;
+	}
+	boardSize = (int)header->boardSize;
+	table = (const unsigned char*)(file.data() + sizeof(BinaryHeader));
+	return true;
+}
+
+int DistanceTable::size() const {
+	return boardSize;
+}
+
+bool DistanceTable::isValid(const Position& pos) const {
+	return pos.x >= 1 && pos.x <= boardSize && pos.y >= 1 && pos.y <= boardSize;
+}
+
+const unsigned char* DistanceTable::row(const Position& source, int& op) const {
+	op = canonicalSymmetry(source, boardSize);
+	size_t index = canonicalIndex(applySymmetry(op, source, boardSize), boardSize);
+	return table + index * boardSize * boardSize;
+}
+
+int DistanceTable::minJumps(const Position& start, const Position& target) const {
+	if (table == nullptr || !isValid(start) || !isValid(target)) {
+		return -1;
+	}
+
+	int op;
+	const unsigned char* dist = row(start, op);
+	Position t = applySymmetry(op, target, boardSize);
+	unsigned char jumps = dist[(size_t)(t.x - 1) * boardSize + (t.y - 1)];
+	return jumps == UNREACHABLE ? -1 : jumps;
+}
+
+Vector<Position> DistanceTable::path(const Position& start, const Position& target) const {
+	int jumps = minJumps(start, target);
+	if (jumps < 0) {
+		return Vector<Position>();
+	}
+
+	// 从终点出发，每次走到离起点少一跳的相邻格子，所有查询都落在起点所在的同一行
+	int op;
+	const unsigned char* dist = row(start, op);
+	Vector<Position> result;
+	Position curr = target;
+	result.push_back(curr);
+	for (int d = jumps - 1; d >= 0; d--) {
+		for (int i = 0; i < 8; i++) {
+			Position prev(curr.x + Chessboard::dx[i], curr.y + Chessboard::dy[i]);
+			if (!isValid(prev)) {
+				continue;
+			}
+			Position p = applySymmetry(op, prev, boardSize);
+			if (dist[(size_t)(p.x - 1) * boardSize + (p.y - 1)] == d) {
+				curr = prev;
+				break;
+			}
+		}
+		result.push_back(curr);
+	}
+	return result;
+}
@@ -0,0 +1,81 @@
+﻿#pragma once
+#include "Chessboard.h"
+#include "MappedFile.h"
+#include "Vector.h"
+
+/**
+ * 固定棋盘大小的全点对跳数表。
+ *
+ * 离线构建时只对基本区域（1/8 棋盘）内的起点计算整张距离场，每格 1 字节，
+ * 查询时先把起点用对称变换映射到基本区域，再读一次表即可得到最小跳数。
+ * 文件使用 BinaryFormat.h 中的文件头（kind 为 BINARY_KIND_DISTANCE_TABLE），
+ * 通过内存映射打开，不需要把整张表读入内存。
+ */
+class DistanceTable {
+private:
+	MappedFile file; // 映射的表文件
+	const unsigned char* table; // 表数据起始地址
+	int boardSize; // 棋盘大小
+
+public:
+	static const unsigned char UNREACHABLE = 0xFF; // 表中不可达的标记
+	static const int MAX_BOARD_SIZE = 256; // 跳数需要能放进 1 字节
+
+	/**
+	 * 默认构造函数，创建一个未打开的表。
+	 */
+	DistanceTable();
+
+	/**
+	 * 离线构建跳数表并写入文件。
+	 *
+	 * @param boardSize_ 棋盘大小（不超过 MAX_BOARD_SIZE）
+	 * @param fileName 输出文件名
+	 * @return 构建成功返回 true，否则返回 false
+	 */
+	static bool build(int boardSize_, const char* fileName);
+
+	/**
+	 * 以内存映射方式打开跳数表。
+	 *
+	 * @param fileName 表文件名
+	 * @return 打开成功返回 true，否则返回 false
+	 */
+	bool open(const char* fileName);
+
+	/**
+	 * 获取表对应的棋盘大小。
+	 *
+	 * @return 棋盘大小，未打开时为 0
+	 */
+	int size() const;
+
+	/**
+	 * 查询两格之间的最小跳数。
+	 *
+	 * @param start 起始位置
+	 * @param target 目标位置
+	 * @return 最小跳数，不可达或坐标非法时返回 -1
+	 */
+	int minJumps(const Chessboard::Position& start, const Chessboard::Position& target) const;
+
+	/**
+	 * 沿跳数表贪心下降恢复一条最短路径。
+	 *
+	 * @param start 起始位置
+	 * @param target 目标位置
+	 * @return 路径位置列表（与 Chessboard 各求解函数相同，终点在前），不可达时返回空列表
+	 */
+	Vector<Chessboard::Position> path(const Chessboard::Position& start, const Chessboard::Position& target) const;
+
+private:
+	/**
+	 * 检查坐标是否在棋盘范围内。
+	 */
+	bool isValid(const Chessboard::Position& pos) const;
+
+	/**
+	 * 获取以 source 为起点的距离场所在的表行，并给出把 source 映射到基本区域的变换。
+	 */
+	const unsigned char* row(const Chessboard::Position& source, int& op) const;
+};
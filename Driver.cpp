@@ -0,0 +1,469 @@
+﻿#include <iostream>
+#include <fstream>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "Driver.h"
+#include "DistanceTable.h"
+#include "JsonQueryReader.h"
+#include "UnboundedBoard.h"
+#include "TextBuffer.h"
+#include "OutputSink.h"
+
+typedef Driver::Position Position;
+
+/**
+ * 一个工作线程运行求解器所需的上下文，棋盘和双向搜索求解器每个线程各有一份。
+ */
+struct SolverContext {
+	Chessboard* board; // 已设置好查询的棋盘
+	UnboundedBoard* unbounded; // 与棋盘同样大小的双向搜索求解器
+	const DistanceTable* table; // 跳数表，未指定 --table 时为空
+	Position start; // 起始位置
+	Position target; // 目标位置
+};
+
+/**
+ * 求解器条目：名称、说明、允许的最大棋盘，以及求一条路径的函数（路径终点在前，不可达时为空）。
+ */
+struct DriverSolver {
+	const char* name;
+	const char* description;
+	int maxBoardSize; // 超过该大小的棋盘不求解，0 表示只受 Chessboard::MAX_BOARD_SIZE 限制
+	Vector<Position> (*run)(SolverContext& ctx);
+};
+
+static Vector<Position> runBFS(SolverContext& ctx) {
+	return ctx.board->optimalPathBFS();
+}
+
+static Vector<Position> runLayered(SolverContext& ctx) {
+	return ctx.board->optimalPathLayeredBFS();
+}
+
+static Vector<Position> runSymmetric(SolverContext& ctx) {
+	return ctx.board->symmetricPathBFS();
+}
+
+static Vector<Position> runBranchBound(SolverContext& ctx) {
+	return ctx.board->branchBoundPath();
+}
+
+static Vector<Position> runAStar(SolverContext& ctx) {
+	return ctx.board->astarPath();
+}
+
+static Vector<Position> runDFS(SolverContext& ctx) {
+	return ctx.board->feasiblePathDFS();
+}
+
+static Vector<Position> runBidirectional(SolverContext& ctx) {
+	return ctx.unbounded->shortestPath(ctx.start, ctx.target);
+}
+
+static Vector<Position> runShortest(SolverContext& ctx) {
+	return ctx.board->shortestPath();
+}
+
+static Vector<Position> runTable(SolverContext& ctx) {
+	return ctx.table->path(ctx.start, ctx.target);
+}
+
+// feasiblePathDFS 不以跳数为界，路径长度和回溯次数随棋盘面积增长，只在小棋盘上求解（与 Benchmark 的默认上限相同）
+static const DriverSolver SOLVERS[] = {
+	{ "bfs", "广度优先搜索 optimalPathBFS", 0, runBFS },
+	{ "layered", "分层广度优先搜索 optimalPathLayeredBFS", 0, runLayered },
+	{ "symmetric", "利用对称性的 symmetricPathBFS", 0, runSymmetric },
+	{ "bb", "分支限界 branchBoundPath", 0, runBranchBound },
+	{ "astar", "A* 搜索 astarPath", 0, runAStar },
+	{ "dfs", "深度优先搜索可行解 feasiblePathDFS（棋盘不超过 64）", 64, runDFS },
+	{ "bidirectional", "哈希表上的双向广度优先搜索 UnboundedBoard", 0, runBidirectional },
+	{ "shortest", "快速预判，不能直接回答时再用 optimalPathBFS", 0, runShortest },
+	{ "table", "查询 --table 指定的跳数表 DistanceTable", 0, runTable },
+};
+
+static const int SOLVER_COUNT = sizeof(SOLVERS) / sizeof(SOLVERS[0]);
+
+static const DriverSolver* findSolver(const char* name) {
+	for (int i = 0; i < SOLVER_COUNT; i++) {
+		if (strcmp(SOLVERS[i].name, name) == 0) {
+			return &SOLVERS[i];
+		}
+	}
+	return nullptr;
+}
+
+Driver::Driver()
+	: boardSize(32), solverName(nullptr), inputName("input.txt"), outputName(nullptr), format(FORMAT_TEXT), formatGiven(false),
+	threads(1), renderName(nullptr), tableName(nullptr), headless(false), asyncOutput(false) {
+}
+
+void Driver::printUsage(std::ostream& out) {
+	out << "用法: 跳马 [--size N] [--solver 名称] [--input 文件] [--output 文件] [--format text|json|binary]\n"
+		<< "            [--threads N] [--render 文件] [--table 文件] [--headless] [--async-output]\n"
+		<< "输入文件扩展名为 .jsonl 时按 JSON Lines 读取，每行 {\"start\": {...}, \"target\": {...}, \"boardSize\": N}。\n"
+		<< "不指定 --solver 时读取 input.txt 并运行 Chessboard::solve()。\n"
+		<< "求解器:\n";
+	for (int i = 0; i < SOLVER_COUNT; i++) {
+		out << "  " << SOLVERS[i].name << "\t" << SOLVERS[i].description << "\n";
+	}
+}
+
+bool Driver::parse(int argc, char* argv[]) {
+	for (int i = 1; i < argc; i++) {
+		bool hasValue = i + 1 < argc;
+		if (strcmp(argv[i], "--size") == 0 && hasValue) {
+			boardSize = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--solver") == 0 && hasValue) {
+			solverName = argv[++i];
+		} else if (strcmp(argv[i], "--input") == 0 && hasValue) {
+			inputName = argv[++i];
+		} else if (strcmp(argv[i], "--output") == 0 && hasValue) {
+			outputName = argv[++i];
+		} else if (strcmp(argv[i], "--format") == 0 && hasValue) {
+			const char* name = argv[++i];
+			formatGiven = true;
+			if (strcmp(name, "text") == 0) {
+				format = FORMAT_TEXT;
+			} else if (strcmp(name, "json") == 0) {
+				format = FORMAT_JSON;
+			} else if (strcmp(name, "binary") == 0) {
+				format = FORMAT_BINARY;
+			} else {
+				std::cerr << "未知的输出格式: " << name << std::endl;
+				printUsage(std::cerr);
+				return false;
+			}
+		} else if (strcmp(argv[i], "--threads") == 0 && hasValue) {
+			threads = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--render") == 0 && hasValue) {
+			renderName = argv[++i];
+		} else if (strcmp(argv[i], "--table") == 0 && hasValue) {
+			tableName = argv[++i];
+		} else if (strcmp(argv[i], "--headless") == 0) {
+			headless = true;
+		} else if (strcmp(argv[i], "--async-output") == 0) {
+			asyncOutput = true;
+		} else {
+			std::cerr << "未知参数: " << argv[i] << std::endl;
+			printUsage(std::cerr);
+			return false;
+		}
+	}
+
+	if (boardSize < 1 || boardSize > Chessboard::MAX_BOARD_SIZE) {
+		std::cerr << "棋盘大小必须在 1 到 " << Chessboard::MAX_BOARD_SIZE << " 之间" << std::endl;
+		return false;
+	}
+	if (threads < 1) {
+		threads = 1;
+	}
+	const DriverSolver* solver = solverName != nullptr ? findSolver(solverName) : nullptr;
+	if (solverName != nullptr && solver == nullptr) {
+		std::cerr << "未知的求解器: " << solverName << std::endl;
+		printUsage(std::cerr);
+		return false;
+	}
+	if (solver != nullptr && solver->maxBoardSize != 0 && boardSize > solver->maxBoardSize) {
+		std::cerr << solverName << " 求解器只支持不超过 " << solver->maxBoardSize << " 的棋盘" << std::endl;
+		return false;
+	}
+	if (solverName != nullptr && strcmp(solverName, "table") == 0 && tableName == nullptr) {
+		std::cerr << "table 求解器需要用 --table 指定跳数表文件" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * 检查文件名是否以 .jsonl 结尾。
+ */
+static bool isJsonLines(const char* fileName) {
+	size_t length = strlen(fileName);
+	return length >= 6 && strcmp(fileName + length - 6, ".jsonl") == 0;
+}
+
+int Driver::run() {
+	if (solverName == nullptr) {
+		Chessboard chessboard(boardSize);
+		chessboard.setDisplayEnabled(!headless);
+		chessboard.setAsyncOutput(asyncOutput);
+		chessboard.solve();
+		return 0;
+	}
+
+	DistanceTable table;
+	if (tableName != nullptr) {
+		if (!table.open(tableName)) {
+			std::cerr << "无法打开跳数表: " << tableName << std::endl;
+			return 1;
+		}
+		// 跳数表只能回答建表时的棋盘大小
+		boardSize = table.size();
+	}
+
+	bool jsonl = isJsonLines(inputName);
+	QueryReader reader;
+	JsonQueryReader jsonReader;
+	if (!(jsonl ? jsonReader.open(inputName) : reader.open(inputName))) {
+		std::cerr << "无法打开输入文件: " << inputName << std::endl;
+		return 1;
+	}
+	if (jsonl && !formatGiven) {
+		format = FORMAT_JSON;
+	}
+
+	const char* name = outputName;
+	if (name == nullptr) {
+		name = format == FORMAT_JSON ? (jsonl ? "output.jsonl" : "output.json") : format == FORMAT_BINARY ? "output.bin" : "output.txt";
+	}
+	bool toConsole = strcmp(name, "-") == 0 && format != FORMAT_BINARY;
+	std::ofstream file;
+	if (!toConsole) {
+		file.open(name, format == FORMAT_BINARY ? std::ios::binary : std::ios::out);
+		if (!file.is_open()) {
+			std::cerr << "无法打开输出文件: " << name << std::endl;
+			return 1;
+		}
+	}
+	std::ostream& out = toConsole ? std::cout : file;
+	// 异步写出时由后台线程把整块结果写入文件，求解下一批与写出上一批同时进行
+	std::unique_ptr<OutputSink> sink;
+	if (asyncOutput) {
+		sink.reset(new OutputSink(out, true));
+	}
+
+	// 每批读取 BATCH_SIZE 个查询，求解后立即写出
+	const size_t BATCH_SIZE = 4096;
+	Vector<Query> batch;
+	size_t total = 0;
+	size_t skippedQueries = 0; // 因内存不足或棋盘超过求解器上限而跳过的查询数
+	size_t firstSkippedQuery = 0; // 第一个被跳过的查询的序号（从 1 开始）
+	double seconds = 0;
+	while (true) {
+		batch.resize(0);
+		Query query;
+		while (batch.size() < BATCH_SIZE && (jsonl ? jsonReader.next(query) : reader.next(query))) {
+			if (query.boardSize <= 0) {
+				query.boardSize = boardSize;
+			}
+			batch.push_back(query);
+		}
+		if (batch.empty()) {
+			break;
+		}
+
+		Vector<Vector<Position> > results(batch.size());
+		Vector<unsigned char> skipped(batch.size(), 0);
+		auto begin = std::chrono::high_resolution_clock::now();
+		solveBatch(batch, tableName != nullptr ? &table : nullptr, results, skipped);
+		auto end = std::chrono::high_resolution_clock::now();
+		seconds += std::chrono::duration<double>(end - begin).count();
+		for (size_t i = 0; i < skipped.size(); i++) {
+			if (skipped[i] && skippedQueries++ == 0) {
+				firstSkippedQuery = total + i + 1;
+			}
+		}
+
+		if (!writeBatch(batch, results, skipped, out)) {
+			std::cerr << "写入结果失败: " << name << std::endl;
+			return 1;
+		}
+		// 第一批不满一批且只有一个查询时，说明整个文件只有这一个查询
+		bool single = total == 0 && batch.size() == 1;
+		if (renderName != nullptr && !renderBatch(batch, results, skipped, total, single)) {
+			std::cerr << "导出图像失败: " << renderName << std::endl;
+			return 1;
+		}
+		total += batch.size();
+	}
+	sink.reset(); // 写出剩余的块并恢复原来的 rdbuf
+	out.flush();
+	if (!out) {
+		std::cerr << "写入结果失败: " << name << std::endl;
+		return 1;
+	}
+
+	std::cerr << "求解器 " << solverName << " 回答 " << total - skippedQueries << " 个查询，用时 "
+		<< seconds << " 秒（" << threads << " 个线程）" << std::endl;
+	if (skippedQueries > 0) {
+		std::cerr << "跳过 " << skippedQueries << " 个无法求解的查询（内存不足或棋盘超过求解器上限，第一个是第 " << firstSkippedQuery
+			<< " 个查询），这些查询没有写出结果" << std::endl;
+	}
+	if (!jsonl && reader.failed()) {
+		// 文本查询文件中途无法解析时不能当作正常结束，否则后面的查询会被悄悄丢掉
+		std::cerr << "查询文件第 " << reader.errorLine() << " 行（第 " << reader.errorOffset()
+			<< " 字节）无法解析，之后的查询没有回答" << std::endl;
+		return 1;
+	}
+	if (jsonl && jsonReader.skippedLines() > 0) {
+		std::cerr << "跳过 " << jsonReader.skippedLines() << " 行无效输入（第一处在第 "
+			<< jsonReader.firstSkippedLine() << " 行）" << std::endl;
+	}
+	return 0;
+}
+
+/**
+ * 把一批查询分给各个工作线程求解。每个线程有自己的 Chessboard 和 UnboundedBoard，
+ * 遇到不同大小的棋盘时重新创建；按每次 64 个查询的块从共享计数器领取任务，结果写入各自的下标，互不干扰。
+ * 使用跳数表时，棋盘大小与表不同的查询视为不可达。
+ * 棋盘超过求解器上限的查询和求解时内存不足（std::bad_alloc）的查询在 skipped 中标记，不会让工作线程把整个进程终止。
+ */
+void Driver::solveBatch(const Vector<Query>& queries, const DistanceTable* table, Vector<Vector<Position> >& results, Vector<unsigned char>& skipped) const {
+	const DriverSolver* solver = findSolver(solverName);
+	const size_t CHUNK = 64;
+	std::atomic<size_t> next(0);
+	const Query* items = queries.begin();
+	Vector<Position>* out = results.begin();
+	unsigned char* failed = skipped.begin();
+	size_t count = queries.size();
+
+	auto worker = [&]() {
+		std::unique_ptr<Chessboard> board;
+		std::unique_ptr<UnboundedBoard> unbounded;
+		SolverContext ctx = { nullptr, nullptr, table, Position(), Position() };
+		while (true) {
+			size_t first = next.fetch_add(CHUNK);
+			if (first >= count) {
+				break;
+			}
+			size_t last = first + CHUNK < count ? first + CHUNK : count;
+			for (size_t i = first; i < last; i++) {
+				int size = items[i].boardSize;
+				if (table != nullptr && size != table->size()) {
+					out[i] = Vector<Position>();
+					continue;
+				}
+				if (solver->maxBoardSize != 0 && size > solver->maxBoardSize) {
+					failed[i] = 1;
+					continue;
+				}
+				try {
+					if (!board || board->size() != size) {
+						board.reset();
+						unbounded.reset();
+						board.reset(new Chessboard(size));
+						board->setDisplayEnabled(false);
+						unbounded.reset(new UnboundedBoard(size));
+						ctx.board = board.get();
+						ctx.unbounded = unbounded.get();
+					}
+					ctx.start = items[i].start;
+					ctx.target = items[i].target;
+					board->setQuery(ctx.start, ctx.target);
+					out[i] = solver->run(ctx);
+				} catch (const std::bad_alloc&) {
+					// 释放这个线程的棋盘，下一个查询重新创建
+					board.reset();
+					unbounded.reset();
+					out[i] = Vector<Position>();
+					failed[i] = 1;
+				}
+			}
+		}
+	};
+
+	size_t workerCount = (size_t)threads;
+	if (workerCount > (count + CHUNK - 1) / CHUNK) {
+		workerCount = (count + CHUNK - 1) / CHUNK;
+	}
+	if (workerCount <= 1) {
+		worker();
+		return;
+	}
+	std::vector<std::thread> pool;
+	for (size_t t = 0; t < workerCount; t++) {
+		pool.push_back(std::thread(worker));
+	}
+	for (size_t t = 0; t < pool.size(); t++) {
+		pool[t].join();
+	}
+}
+
+/**
+ * 按选定的格式写出一批结果，顺序与查询文件相同。
+ */
+bool Driver::writeBatch(const Vector<Query>& queries, const Vector<Vector<Position> >& results, const Vector<unsigned char>& skipped, std::ostream& out) const {
+	if (format == FORMAT_TEXT) {
+		TextBuffer buffer(out);
+		for (size_t i = 0; i < results.size(); i++) {
+			if (skipped[i]) {
+				continue;
+			}
+			Chessboard::writeText(results[i], buffer);
+		}
+		buffer.flush();
+		return (bool)out;
+	}
+
+	// writeJson 和 writeBinaryPath 从棋盘上取起点、终点和棋盘大小，棋盘大小变化时重新创建
+	std::unique_ptr<Chessboard> board;
+	if (format == FORMAT_JSON) {
+		TextBuffer buffer(out);
+		for (size_t i = 0; i < results.size(); i++) {
+			if (skipped[i]) {
+				continue;
+			}
+			if (!board || board->size() != queries[i].boardSize) {
+				board.reset(new Chessboard(queries[i].boardSize));
+			}
+			board->setQuery(queries[i].start, queries[i].target);
+			board->writeJson(results[i], buffer);
+			buffer.appendChar('\n');
+		}
+		buffer.flush();
+		return (bool)out;
+	}
+
+	for (size_t i = 0; i < results.size(); i++) {
+		if (skipped[i]) {
+			continue;
+		}
+		if (!board || board->size() != queries[i].boardSize) {
+			board.reset(new Chessboard(queries[i].boardSize));
+		}
+		board->setQuery(queries[i].start, queries[i].target);
+		if (!board->writeBinaryPath(results[i], out)) {
+			return false;
+		}
+	}
+	return (bool)out;
+}
+
+/**
+ * 把一批查询的路径导出为图像。整个输入只有一个查询时直接使用 --render 指定的文件名，
+ * 否则在扩展名之前插入查询序号，例如 route.png 变为 route-0.png、route-1.png。
+ */
+bool Driver::renderBatch(const Vector<Query>& queries, const Vector<Vector<Position> >& results, const Vector<unsigned char>& skipped, size_t firstIndex, bool single) const {
+	std::string base(renderName);
+	size_t dot = base.find_last_of('.');
+	size_t slash = base.find_last_of("/\\");
+	if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+		dot = base.size();
+	}
+	std::unique_ptr<Chessboard> board;
+	for (size_t i = 0; i < results.size(); i++) {
+		if (skipped[i]) {
+			continue;
+		}
+		std::string fileName = base;
+		if (!single) {
+			fileName = base.substr(0, dot) + "-" + std::to_string(firstIndex + i) + base.substr(dot);
+		}
+		if (!board || board->size() != queries[i].boardSize) {
+			board.reset(new Chessboard(queries[i].boardSize));
+		}
+		board->setQuery(queries[i].start, queries[i].target);
+		if (!board->exportPathImage(results[i], fileName.c_str())) {
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,77 @@
+﻿#pragma once
+#include <iosfwd>
+#include "Chessboard.h"
+#include "Vector.h"
+#include "QueryReader.h"
+
+class DistanceTable;
+
+/**
+ * 命令行驱动：解析命令行参数，用选定的一个求解器批量回答查询并写出结果。
+ * 查询按批读取、求解和写出，内存占用与查询总数无关。
+ *
+ * 用法：跳马 [--size N] [--solver 名称] [--input 文件] [--output 文件] [--format text|json|binary]
+ *            [--threads N] [--render 文件] [--table 文件] [--headless] [--async-output]
+ *
+ * 输入文件扩展名为 .jsonl 时按 JSON Lines 读取（见 JsonQueryReader.h），结果默认也以 JSON Lines 写出。
+ * 不指定 --solver 时保持原来的行为：读取 input.txt，在 N（默认 32）大小的棋盘上调用 Chessboard::solve()。
+ */
+class Driver {
+public:
+	typedef Chessboard::Position Position;
+
+	typedef ::Query Query;
+
+	enum OutputFormat {
+		FORMAT_TEXT, // 与 README 中 output.txt 相同的 "Minimum Jumps" / "Path" 两行
+		FORMAT_JSON, // 每行一个 output.json 格式的对象（JSON Lines）
+		FORMAT_BINARY // 依次写出 writeBinaryPath 格式的记录
+	};
+
+private:
+	int boardSize; // 查询本身没有指定棋盘大小时使用的棋盘大小
+	const char* solverName; // 求解器名称，为空时运行 Chessboard::solve()
+	const char* inputName; // 查询文件
+	const char* outputName; // 结果文件，"-" 表示标准输出
+	OutputFormat format; // 结果格式
+	bool formatGiven; // 是否指定了 --format
+	int threads; // 工作线程数
+	const char* renderName; // 不为空时把路径导出为图像
+	const char* tableName; // table 求解器使用的跳数表文件
+	bool headless; // 不打开图像窗口
+	bool asyncOutput; // 结果由后台线程写出（见 OutputSink.h）
+
+public:
+	/**
+	 * 构造函数，所有选项取默认值。
+	 */
+	Driver();
+
+	/**
+	 * 解析命令行参数，出错时把原因和用法打印到标准错误。
+	 *
+	 * @param argc 参数个数
+	 * @param argv 参数列表
+	 * @return 参数合法返回 true，否则返回 false
+	 */
+	bool parse(int argc, char* argv[]);
+
+	/**
+	 * 按解析得到的选项运行。
+	 *
+	 * @return 进程退出码
+	 */
+	int run();
+
+	/**
+	 * 打印用法说明。
+	 *
+	 * @param out 输出流
+	 */
+	static void printUsage(std::ostream& out);
+
+private:
+	void solveBatch(const Vector<Query>& queries, const DistanceTable* table, Vector<Vector<Position> >& results, Vector<unsigned char>& skipped) const;
+	bool writeBatch(const Vector<Query>& queries, const Vector<Vector<Position> >& results, const Vector<unsigned char>& skipped, std::ostream& out) const;
+	bool renderBatch(const Vector<Query>& queries, const Vector<Vector<Position> >& results, const Vector<unsigned char>& skipped, size_t firstIndex, bool single) const;
+};
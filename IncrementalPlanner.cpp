@@ -0,0 +1,169 @@
+﻿#include <algorithm>
+
+#include "IncrementalPlanner.h"
+
+typedef IncrementalPlanner::Position Position;
+
+const int IncrementalPlanner::INF;
+
+IncrementalPlanner::IncrementalPlanner(int boardSize_, const Position& start_, const Position& goal_)
+	: boardSize(boardSize_), start(start_), goal(goal_),
+	g((size_t)boardSize_ * boardSize_, INF), rhs((size_t)boardSize_ * boardSize_, INF),
+	blocked((size_t)boardSize_ * boardSize_, 0), queued((size_t)boardSize_ * boardSize_, 0),
+	queuedKey((size_t)boardSize_ * boardSize_), expanded(0) {
+	if (isValid(start.x, start.y)) {
+		size_t idx = cellIndex(start.x, start.y);
+		rhs.begin()[idx] = 0;
+		queuedKey.begin()[idx] = calculateKey(idx, start.x, start.y);
+		queued.begin()[idx] = 1;
+		open.insert(OpenEntry(queuedKey.begin()[idx], idx));
+	}
+}
+
+bool IncrementalPlanner::isValid(int x, int y) const {
+	return x >= 1 && x <= boardSize && y >= 1 && y <= boardSize;
+}
+
+size_t IncrementalPlanner::cellIndex(int x, int y) const {
+	return (size_t)(x - 1) * boardSize + (y - 1);
+}
+
+bool IncrementalPlanner::isBlocked(int x, int y) const {
+	return isValid(x, y) && blocked.begin()[cellIndex(x, y)] != 0;
+}
+
+size_t IncrementalPlanner::expandedNodes() const {
+	return expanded;
+}
+
+IncrementalPlanner::Key IncrementalPlanner::calculateKey(size_t idx, int x, int y) const {
+	int best = std::min(g.begin()[idx], rhs.begin()[idx]);
+	int h = Chessboard::knightLowerBound(goal.x - x, goal.y - y);
+	return Key(best >= INF ? INF : best + h, best);
+}
+
+/**
+ * 重新计算格子的 rhs 值，并根据 g 与 rhs 是否一致把它放入或移出开放表。
+ */
+void IncrementalPlanner::updateVertex(int x, int y) {
+	if (!isValid(x, y)) {
+		return;
+	}
+	size_t idx = cellIndex(x, y);
+	int* rhsCells = rhs.begin();
+
+	if (blocked.begin()[idx]) {
+		rhsCells[idx] = INF;
+	} else if (x == start.x && y == start.y) {
+		rhsCells[idx] = 0;
+	} else {
+		int best = INF;
+		for (int i = 0; i < 8; i++) {
+			int prevX = x + Chessboard::dx[i];
+			int prevY = y + Chessboard::dy[i];
+			if (isValid(prevX, prevY)) {
+				size_t prev = cellIndex(prevX, prevY);
+				if (!blocked.begin()[prev] && g.begin()[prev] + 1 < best) {
+					best = g.begin()[prev] + 1;
+				}
+			}
+		}
+		rhsCells[idx] = best;
+	}
+
+	if (queued.begin()[idx]) {
+		open.erase(OpenEntry(queuedKey.begin()[idx], idx));
+		queued.begin()[idx] = 0;
+	}
+	if (g.begin()[idx] != rhsCells[idx]) {
+		queuedKey.begin()[idx] = calculateKey(idx, x, y);
+		queued.begin()[idx] = 1;
+		open.insert(OpenEntry(queuedKey.begin()[idx], idx));
+	}
+}
+
+void IncrementalPlanner::computeShortestPath() {
+	size_t goalIdx = cellIndex(goal.x, goal.y);
+	int* gCells = g.begin();
+	int* rhsCells = rhs.begin();
+
+	while (!open.empty()) {
+		OpenEntry top = *open.begin();
+		if (!(top.first < calculateKey(goalIdx, goal.x, goal.y)) && rhsCells[goalIdx] == gCells[goalIdx]) {
+			break;
+		}
+		open.erase(open.begin());
+		size_t idx = top.second;
+		queued.begin()[idx] = 0;
+		expanded++;
+
+		int x = (int)(idx / boardSize) + 1;
+		int y = (int)(idx % boardSize) + 1;
+		if (gCells[idx] > rhsCells[idx]) {
+			// 过一致：跳数变小，确定下来并更新后继
+			gCells[idx] = rhsCells[idx];
+		} else {
+			// 欠一致：原来的路径失效，先置为无穷大，再重新评估自身和后继
+			gCells[idx] = INF;
+			updateVertex(x, y);
+		}
+		for (int i = 0; i < 8; i++) {
+			updateVertex(x + Chessboard::dx[i], y + Chessboard::dy[i]);
+		}
+	}
+}
+
+void IncrementalPlanner::block(int x, int y) {
+	if (!isValid(x, y) || blocked.begin()[cellIndex(x, y)]) {
+		return;
+	}
+	blocked.begin()[cellIndex(x, y)] = 1;
+	updateVertex(x, y);
+	for (int i = 0; i < 8; i++) {
+		updateVertex(x + Chessboard::dx[i], y + Chessboard::dy[i]);
+	}
+}
+
+void IncrementalPlanner::unblock(int x, int y) {
+	if (!isValid(x, y) || !blocked.begin()[cellIndex(x, y)]) {
+		return;
+	}
+	blocked.begin()[cellIndex(x, y)] = 0;
+	updateVertex(x, y);
+	for (int i = 0; i < 8; i++) {
+		updateVertex(x + Chessboard::dx[i], y + Chessboard::dy[i]);
+	}
+}
+
+Vector<Position> IncrementalPlanner::path() {
+	expanded = 0;
+	if (!isValid(start.x, start.y) || !isValid(goal.x, goal.y)) {
+		return Vector<Position>();
+	}
+	computeShortestPath();
+
+	const int* gCells = g.begin();
+	if (gCells[cellIndex(goal.x, goal.y)] >= INF) {
+		return Vector<Position>();
+	}
+
+	// 从终点出发，每次走到 g 值最小的相邻空格
+	Vector<Position> result;
+	Position curr = goal;
+	result.push_back(curr);
+	while (!(curr.x == start.x && curr.y == start.y)) {
+		Position next = curr;
+		int best = INF;
+		for (int i = 0; i < 8; i++) {
+			int prevX = curr.x + Chessboard::dx[i];
+			int prevY = curr.y + Chessboard::dy[i];
+			if (isValid(prevX, prevY) && !blocked.begin()[cellIndex(prevX, prevY)] && gCells[cellIndex(prevX, prevY)] < best) {
+				best = gCells[cellIndex(prevX, prevY)];
+				next = Position(prevX, prevY);
+			}
+		}
+		curr = next;
+		result.push_back(curr);
+	}
+	return result;
+}
@@ -0,0 +1,91 @@
+﻿#pragma once
+#include <set>
+#include <utility>
+#include "Chessboard.h"
+#include "Vector.h"
+
+/**
+ * 障碍会变化时的增量路径规划器（Lifelong Planning A*）。
+ *
+ * 规划器在多次查询之间保留每个格子的 g 值（当前估计的跳数）和 rhs 值（由前驱推出的单步前瞻值），
+ * 调用 block / unblock 修改障碍后，只有两者不再一致的格子会重新进入开放表，
+ * 下一次 path 只修复受影响的区域，而不是从头搜索整张棋盘。
+ * 启发函数使用 Chessboard::knightLowerBound，它是一致的，保证结果最优。
+ */
+class IncrementalPlanner {
+public:
+	typedef Chessboard::Position Position;
+
+private:
+	typedef std::pair<int, int> Key;
+	typedef std::pair<Key, size_t> OpenEntry;
+
+	static const int INF = 0x3FFFFFFF;
+
+	int boardSize; // 棋盘大小
+	Position start; // 起始位置
+	Position goal; // 目标位置
+	Vector<int> g; // 当前估计的跳数
+	Vector<int> rhs; // 单步前瞻值
+	Vector<unsigned char> blocked; // 障碍标记
+	Vector<unsigned char> queued; // 是否在开放表中
+	Vector<Key> queuedKey; // 在开放表中的键
+	std::set<OpenEntry> open; // 开放表
+	size_t expanded; // 上一次修复展开的格子数
+
+public:
+	/**
+	 * 构造函数，起点和终点在规划器的整个生命周期内固定。
+	 *
+	 * @param boardSize_ 棋盘大小
+	 * @param start_ 起始位置
+	 * @param goal_ 目标位置
+	 */
+	IncrementalPlanner(int boardSize_, const Position& start_, const Position& goal_);
+
+	/**
+	 * 把格子设为障碍。
+	 *
+	 * @param x 横坐标
+	 * @param y 纵坐标
+	 */
+	void block(int x, int y);
+
+	/**
+	 * 移除格子上的障碍。
+	 *
+	 * @param x 横坐标
+	 * @param y 纵坐标
+	 */
+	void unblock(int x, int y);
+
+	/**
+	 * 检查格子是否为障碍。
+	 *
+	 * @param x 横坐标
+	 * @param y 纵坐标
+	 * @return 是障碍返回 true，否则返回 false
+	 */
+	bool isBlocked(int x, int y) const;
+
+	/**
+	 * 修复搜索状态并返回当前障碍下的最优路径。
+	 *
+	 * @return 路径位置列表（与 Chessboard 各求解函数相同，终点在前），不可达时返回空列表
+	 */
+	Vector<Position> path();
+
+	/**
+	 * 获取上一次 path 调用中展开的格子数，可用于与冷启动搜索比较。
+	 *
+	 * @return 展开的格子数
+	 */
+	size_t expandedNodes() const;
+
+private:
+	bool isValid(int x, int y) const;
+	size_t cellIndex(int x, int y) const;
+	Key calculateKey(size_t idx, int x, int y) const;
+	void updateVertex(int x, int y);
+	void computeShortestPath();
+};
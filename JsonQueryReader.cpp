@@ -0,0 +1,232 @@
+﻿#include <cstring>
+#include <climits>
+#include <nlohmann/json.hpp>
+
+#include "JsonQueryReader.h"
+
+using json = nlohmann::json;
+
+/**
+ * 解析一行查询的 SAX 处理器。只记录顶层的 boardSize 和 start / target 下的 x / y，
+ * 其余字段（包括嵌套更深的内容）都被忽略。
+ */
+class QuerySaxHandler {
+private:
+	enum Field { FIELD_OTHER, FIELD_START, FIELD_TARGET, FIELD_BOARD_SIZE };
+	enum Coordinate { COORD_OTHER, COORD_X, COORD_Y };
+
+	// 已读到的坐标的标记位，四个坐标必须齐全
+	enum { START_X = 1, START_Y = 2, TARGET_X = 4, TARGET_Y = 8, ALL_COORDINATES = 15 };
+
+	Query& query;
+	int depth; // 当前所在的对象或数组的嵌套深度，顶层对象内为 1
+	Field field; // 顶层对象中当前的键
+	Coordinate coordinate; // start / target 对象中当前的键
+	unsigned seen; // 已读到的坐标
+	bool valid; // 已知字段的类型是否都正确
+
+	/**
+	 * 当前值是否落在需要记录的位置上。
+	 */
+	bool wanted() const {
+		if (depth == 1) {
+			return field == FIELD_BOARD_SIZE;
+		}
+		return depth == 2 && (field == FIELD_START || field == FIELD_TARGET) && coordinate != COORD_OTHER;
+	}
+
+	bool integer(long long value) {
+		if (depth == 0) {
+			return false;
+		}
+		if (!wanted()) {
+			return true;
+		}
+		if (value < INT_MIN || value > INT_MAX) {
+			valid = false;
+			return false;
+		}
+		if (depth == 1) {
+			// 超出范围的棋盘大小会让求解器分配失败，整行视为无效
+			if (value < 1 || value > Chessboard::MAX_BOARD_SIZE) {
+				valid = false;
+				return false;
+			}
+			query.boardSize = (int)value;
+			return true;
+		}
+		Chessboard::Position& pos = field == FIELD_START ? query.start : query.target;
+		unsigned bit = field == FIELD_START ? START_X : TARGET_X;
+		if (coordinate == COORD_X) {
+			pos.x = (int)value;
+		} else {
+			pos.y = (int)value;
+			bit <<= 1;
+		}
+		seen |= bit;
+		return true;
+	}
+
+	/**
+	 * 遇到非整数的值：出现在需要记录的位置上时整行无效，否则忽略。
+	 */
+	bool other() {
+		if (depth == 0 || wanted()) {
+			valid = false;
+			return false;
+		}
+		return true;
+	}
+
+public:
+	explicit QuerySaxHandler(Query& query_)
+		: query(query_), depth(0), field(FIELD_OTHER), coordinate(COORD_OTHER), seen(0), valid(true) {
+		query.boardSize = 0;
+	}
+
+	/**
+	 * 检查是否读到了完整的查询。
+	 */
+	bool complete() const {
+		return valid && seen == ALL_COORDINATES;
+	}
+
+	bool null() {
+		return other();
+	}
+
+	bool boolean(bool) {
+		return other();
+	}
+
+	bool number_integer(json::number_integer_t value) {
+		return integer(value);
+	}
+
+	bool number_unsigned(json::number_unsigned_t value) {
+		return integer(value > (json::number_unsigned_t)INT_MAX ? (long long)INT_MAX + 1 : (long long)value);
+	}
+
+	bool number_float(json::number_float_t, const json::string_t&) {
+		return other();
+	}
+
+	bool string(json::string_t&) {
+		return other();
+	}
+
+	bool binary(json::binary_t&) {
+		return other();
+	}
+
+	bool start_object(size_t) {
+		if (depth == 1 && field == FIELD_BOARD_SIZE) {
+			valid = false;
+			return false;
+		}
+		depth++;
+		return true;
+	}
+
+	bool key(json::string_t& name) {
+		if (depth == 1) {
+			coordinate = COORD_OTHER;
+			field = name == "start" ? FIELD_START : name == "target" ? FIELD_TARGET : name == "boardSize" ? FIELD_BOARD_SIZE : FIELD_OTHER;
+		} else if (depth == 2) {
+			coordinate = name == "x" ? COORD_X : name == "y" ? COORD_Y : COORD_OTHER;
+		}
+		return true;
+	}
+
+	bool end_object() {
+		depth--;
+		if (depth == 1) {
+			coordinate = COORD_OTHER;
+		}
+		return true;
+	}
+
+	bool start_array(size_t) {
+		if (depth == 0 || wanted() || (depth == 1 && field != FIELD_OTHER)) {
+			valid = false;
+			return false;
+		}
+		depth++;
+		return true;
+	}
+
+	bool end_array() {
+		depth--;
+		return true;
+	}
+
+	bool parse_error(size_t, const std::string&, const nlohmann::detail::exception&) {
+		valid = false;
+		return false;
+	}
+};
+
+JsonQueryReader::JsonQueryReader() : cursor(nullptr), end(nullptr), line(0), skipped(0), firstSkipped(0) {}
+
+bool JsonQueryReader::open(const char* fileName) {
+	cursor = end = nullptr;
+	line = 0;
+	skipped = 0;
+	firstSkipped = 0;
+	if (!file.open(fileName)) {
+		return false;
+	}
+	cursor = file.data();
+	end = cursor + file.size();
+	// 跳过 UTF-8 BOM
+	if (file.size() >= 3 && memcmp(cursor, "\xEF\xBB\xBF", 3) == 0) {
+		cursor += 3;
+	}
+	return true;
+}
+
+/**
+ * 用 SAX 接口解析一行，读到完整的查询时返回 true。
+ */
+bool JsonQueryReader::parseLine(const char* first, const char* last, Query& query) const {
+	QuerySaxHandler handler(query);
+	bool parsed = json::sax_parse(first, last, &handler);
+	return parsed && handler.complete();
+}
+
+bool JsonQueryReader::next(Query& query) {
+	while (cursor != end) {
+		const char* newline = (const char*)memchr(cursor, '\n', end - cursor);
+		const char* first = cursor;
+		const char* last = newline != nullptr ? newline : end;
+		cursor = newline != nullptr ? newline + 1 : end;
+		line++;
+
+		// 忽略行尾的 \r 和只含空白的行
+		while (last != first && (last[-1] == '\r' || last[-1] == ' ' || last[-1] == '\t')) {
+			last--;
+		}
+		while (first != last && (*first == ' ' || *first == '\t')) {
+			first++;
+		}
+		if (first == last) {
+			continue;
+		}
+
+		if (parseLine(first, last, query)) {
+			return true;
+		}
+		if (skipped++ == 0) {
+			firstSkipped = line;
+		}
+	}
+	return false;
+}
+
+size_t JsonQueryReader::skippedLines() const {
+	return skipped;
+}
+
+size_t JsonQueryReader::firstSkippedLine() const {
+	return firstSkipped;
+}
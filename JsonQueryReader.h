@@ -0,0 +1,57 @@
+﻿#pragma once
+#include "MappedFile.h"
+#include "QueryReader.h"
+
+/**
+ * JSON Lines 批量查询文件的读取器，每行一个查询对象：
+ *
+ *     {"start": {"x": 1, "y": 1}, "target": {"x": 8, "y": 8}, "boardSize": 32}
+ *
+ * boardSize 可以省略，给出时必须在 1 到 Chessboard::MAX_BOARD_SIZE 之间。文件通过内存映射打开，每行用 nlohmann::json 的 SAX 接口解析，
+ * 只取出需要的字段，不为每行构造 json 对象树；其他字段被忽略。
+ * 空行被跳过；无法解析或缺少坐标的行也被跳过，并记入 skippedLines。
+ */
+class JsonQueryReader {
+private:
+	MappedFile file; // 映射的查询文件
+	const char* cursor; // 下一行的起始位置
+	const char* end; // 文件结束位置
+	size_t line; // 最近读取的行号（从 1 开始）
+	size_t skipped; // 跳过的无效行数
+	size_t firstSkipped; // 第一个无效行的行号，没有时为 0
+
+public:
+	/**
+	 * 默认构造函数，创建一个未打开的读取器。
+	 */
+	JsonQueryReader();
+
+	/**
+	 * 打开查询文件。
+	 *
+	 * @param fileName 文件名
+	 * @return 打开成功返回 true，否则返回 false
+	 */
+	bool open(const char* fileName);
+
+	/**
+	 * 读取下一个有效的查询。
+	 *
+	 * @param query 输出，读到的查询（没有 boardSize 字段时为 0）
+	 * @return 读到查询返回 true，文件结束返回 false
+	 */
+	bool next(Query& query);
+
+	/**
+	 * 获取跳过的无效行数。
+	 */
+	size_t skippedLines() const;
+
+	/**
+	 * 获取第一个无效行的行号，没有无效行时为 0。
+	 */
+	size_t firstSkippedLine() const;
+
+private:
+	bool parseLine(const char* first, const char* last, Query& query) const;
+};
@@ -1,4 +1,6 @@
 ﻿#pragma once
+#include <cstddef>
+#include "Allocator.h"
 
 template <typename T>
 class ListNode {
@@ -20,7 +22,13 @@ public:
 	ListNode() : prev(nullptr), next(nullptr) {}
 };
 
-template <typename T>
+/**
+ * 双向链表。
+ *
+ * @tparam T 元素类型
+ * @tparam Alloc 内存分配策略（见 Allocator.h），每个节点单独分配
+ */
+template <typename T, typename Alloc = DefaultAllocator>
 class List {
 private:
 	ListNode<T>* head; // 头节点指针
@@ -219,18 +227,18 @@ public:
 };
 
 
-template <typename T>
-List<T>::List() : head(nullptr), tail(nullptr), size_(0) {}
+template <typename T, typename Alloc>
+List<T, Alloc>::List() : head(nullptr), tail(nullptr), size_(0) {}
 
-template <typename T>
-List<T>::List(size_t n, const T& elem) : head(nullptr), tail(nullptr), size_(0) {
+template <typename T, typename Alloc>
+List<T, Alloc>::List(size_t n, const T& elem) : head(nullptr), tail(nullptr), size_(0) {
 	for (size_t i = 0; i < n; i++) {
 		push_back(elem);
 	}
 }
 
-template <typename T>
-List<T>::List(const List& other) : head(nullptr), tail(nullptr), size_(0) {
+template <typename T, typename Alloc>
+List<T, Alloc>::List(const List& other) : head(nullptr), tail(nullptr), size_(0) {
 	ListNode<T>* current = other.head;
 	while (current != nullptr) {
 		push_back(current->data);
@@ -238,15 +246,15 @@ List<T>::List(const List& other) : head(nullptr), tail(nullptr), size_(0) {
 	}
 }
 
-template <typename T>
-List<T>::List(List&& other) : head(other.head), tail(other.tail), size_(other.size_) {
+template <typename T, typename Alloc>
+List<T, Alloc>::List(List&& other) : head(other.head), tail(other.tail), size_(other.size_) {
 	other.head = nullptr;
 	other.tail = nullptr;
 	other.size_ = 0;
 }
 
-template <typename T>
-List<T>::List(ListNode<T>* begin, ListNode<T>* end) : head(nullptr), tail(nullptr), size_(0) {
+template <typename T, typename Alloc>
+List<T, Alloc>::List(ListNode<T>* begin, ListNode<T>* end) : head(nullptr), tail(nullptr), size_(0) {
 	ListNode<T>* current = begin;
 	while (current != end) {
 		push_back(current->data);
@@ -254,13 +262,13 @@ List<T>::List(ListNode<T>* begin, ListNode<T>* end) : head(nullptr), tail(nullpt
 	}
 }
 
-template <typename T>
-List<T>::~List() {
+template <typename T, typename Alloc>
+List<T, Alloc>::~List() {
 	clear();
 }
 
-template <typename T>
-List<T>& List<T>::operator=(const List& other) {
+template <typename T, typename Alloc>
+List<T, Alloc>& List<T, Alloc>::operator=(const List& other) {
 	if (this == &other) {
 		return *this; // 处理自我赋值
 	}
@@ -276,8 +284,8 @@ List<T>& List<T>::operator=(const List& other) {
 	return *this;
 }
 
-template <typename T>
-List<T>& List<T>::operator=(List&& other) {
+template <typename T, typename Alloc>
+List<T, Alloc>& List<T, Alloc>::operator=(List&& other) {
 	if (this == &other) {
 		return *this; // 处理自我赋值
 	}
@@ -295,44 +303,44 @@ List<T>& List<T>::operator=(List&& other) {
 	return *this;
 }
 
-template <typename T>
-T& List<T>::front() {
+template <typename T, typename Alloc>
+T& List<T, Alloc>::front() {
 	return head->data;
 }
 
-template <typename T>
-const T& List<T>::front() const {
+template <typename T, typename Alloc>
+const T& List<T, Alloc>::front() const {
 	return head->data;
 }
 
-template <typename T>
-T& List<T>::back() {
+template <typename T, typename Alloc>
+T& List<T, Alloc>::back() {
 	return tail->data;
 }
 
-template <typename T>
-const T& List<T>::back() const {
+template <typename T, typename Alloc>
+const T& List<T, Alloc>::back() const {
 	return tail->data;
 }
 
-template <typename T>
-ListNode<T>* List<T>::begin() {
+template <typename T, typename Alloc>
+ListNode<T>* List<T, Alloc>::begin() {
 	return head;
 }
 
-template <typename T>
-const ListNode<T>* List<T>::begin() const {
+template <typename T, typename Alloc>
+const ListNode<T>* List<T, Alloc>::begin() const {
 	return head;
 }
 
-template <typename T>
-ListNode<T>* List<T>::end() {
+template <typename T, typename Alloc>
+ListNode<T>* List<T, Alloc>::end() {
 	return nullptr;
 }
 
-template <typename T>
-void List<T>::push_back(const T& val) {
-	ListNode<T>* newNode = new ListNode<T>(val);
+template <typename T, typename Alloc>
+void List<T, Alloc>::push_back(const T& val) {
+	ListNode<T>* newNode = Alloc::template create<ListNode<T> >(val);
 	if (head == nullptr) {
 		head = tail = newNode;
 	} else {
@@ -343,9 +351,9 @@ void List<T>::push_back(const T& val) {
 	size_++;
 }
 
-template <typename T>
-void List<T>::push_front(const T& val) {
-	ListNode<T>* newNode = new ListNode<T>(val);
+template <typename T, typename Alloc>
+void List<T, Alloc>::push_front(const T& val) {
+	ListNode<T>* newNode = Alloc::template create<ListNode<T> >(val);
 	if (head == nullptr) {
 		head = tail = newNode;
 	} else {
@@ -356,8 +364,8 @@ void List<T>::push_front(const T& val) {
 	size_++;
 }
 
-template <typename T>
-void List<T>::insert(ListNode<T>* pos, const T& val) {
+template <typename T, typename Alloc>
+void List<T, Alloc>::insert(ListNode<T>* pos, const T& val) {
 	if (pos == nullptr) {
 		push_back(val);
 		return;
@@ -368,7 +376,7 @@ void List<T>::insert(ListNode<T>* pos, const T& val) {
 		return;
 	}
 
-	ListNode<T>* newNode = new ListNode<T>(val);
+	ListNode<T>* newNode = Alloc::template create<ListNode<T> >(val);
 	newNode->prev = pos->prev;
 	newNode->next = pos;
 	pos->prev->next = newNode;
@@ -377,23 +385,23 @@ void List<T>::insert(ListNode<T>* pos, const T& val) {
 	size_++;
 }
 
-template <typename T>
-void List<T>::insert(ListNode<T>* pos, size_t n, const T& val) {
+template <typename T, typename Alloc>
+void List<T, Alloc>::insert(ListNode<T>* pos, size_t n, const T& val) {
 	for (size_t i = 0; i < n; ++i) {
 		insert(pos, val);
 	}
 }
 
-template <typename T>
-void List<T>::insert(ListNode<T>* pos, ListNode<T>* begin, ListNode<T>* end) {
+template <typename T, typename Alloc>
+void List<T, Alloc>::insert(ListNode<T>* pos, ListNode<T>* begin, ListNode<T>* end) {
 	while (begin != end) {
 		insert(pos, begin->data);
 		begin = begin->next;
 	}
 }
 
-template <typename T>
-void List<T>::pop_back() {
+template <typename T, typename Alloc>
+void List<T, Alloc>::pop_back() {
 	if (tail != nullptr) {
 		ListNode<T>* temp = tail;
 		tail = tail->prev;
@@ -402,13 +410,13 @@ void List<T>::pop_back() {
 		} else {
 			head = nullptr;
 		}
-		delete temp;
+		Alloc::destroy(temp);
 		size_--;
 	}
 }
 
-template <typename T>
-void List<T>::pop_front() {
+template <typename T, typename Alloc>
+void List<T, Alloc>::pop_front() {
 	if (head != nullptr) {
 		ListNode<T>* temp = head;
 		head = head->next;
@@ -417,13 +425,13 @@ void List<T>::pop_front() {
 		} else {
 			tail = nullptr;
 		}
-		delete temp;
+		Alloc::destroy(temp);
 		size_--;
 	}
 }
 
-template <typename T>
-void List<T>::erase(ListNode<T>* begin, ListNode<T>* end) {
+template <typename T, typename Alloc>
+void List<T, Alloc>::erase(ListNode<T>* begin, ListNode<T>* end) {
 	while (begin != end) {
 		ListNode<T>* temp = begin;
 		begin = begin->next;
@@ -434,14 +442,14 @@ void List<T>::erase(ListNode<T>* begin, ListNode<T>* end) {
 		} else {
 			temp->prev->next = temp->next;
 			temp->next->prev = temp->prev;
-			delete temp;
+			Alloc::destroy(temp);
 			size_--;
 		}
 	}
 }
 
-template <typename T>
-void List<T>::erase(const T& val) {
+template <typename T, typename Alloc>
+void List<T, Alloc>::erase(const T& val) {
 	ListNode<T>* current = head;
 	while (current != nullptr) {
 		ListNode<T>* temp = current;
@@ -454,31 +462,31 @@ void List<T>::erase(const T& val) {
 			} else {
 				temp->prev->next = temp->next;
 				temp->next->prev = temp->prev;
-				delete temp;
+				Alloc::destroy(temp);
 				size_--;
 			}
 		}
 	}
 }
 
-template <typename T>
-void List<T>::clear() {
+template <typename T, typename Alloc>
+void List<T, Alloc>::clear() {
 	ListNode<T>* current = head;
 	while (current != nullptr) {
 		ListNode<T>* temp = current;
 		current = current->next;
-		delete temp;
+		Alloc::destroy(temp);
 	}
 	head = tail = nullptr;
 	size_ = 0;
 }
 
-template <typename T>
-size_t List<T>::size() const {
+template <typename T, typename Alloc>
+size_t List<T, Alloc>::size() const {
 	return size_;
 }
 
-template <typename T>
-bool List<T>::empty() const {
+template <typename T, typename Alloc>
+bool List<T, Alloc>::empty() const {
 	return size_ == 0;
 }
@@ -0,0 +1,127 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile() : data_(nullptr), size_(0), fileHandle(INVALID_HANDLE_VALUE), mappingHandle(nullptr) {}
+
+bool MappedFile::open(const char* fileName) {
+	close();
+	HANDLE file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	fileHandle = file;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize)) {
+		close();
+		return false;
+	}
+	size_ = (size_t)fileSize.QuadPart;
+	if (size_ == 0) {
+		return true;
+	}
+
+	mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mappingHandle == nullptr) {
+		close();
+		return false;
+	}
+	data_ = (const char*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	if (data_ == nullptr) {
+		close();
+		return false;
+	}
+	return true;
+}
+
+void MappedFile::close() {
+	if (data_ != nullptr) {
+		UnmapViewOfFile(data_);
+	}
+	if (mappingHandle != nullptr) {
+		CloseHandle(mappingHandle);
+	}
+	if (fileHandle != INVALID_HANDLE_VALUE) {
+		CloseHandle(fileHandle);
+	}
+	data_ = nullptr;
+	size_ = 0;
+	fileHandle = INVALID_HANDLE_VALUE;
+	mappingHandle = nullptr;
+}
+
+bool MappedFile::isOpen() const {
+	return fileHandle != INVALID_HANDLE_VALUE;
+}
+
+#else
+
+MappedFile::MappedFile() : data_(nullptr), size_(0), fd(-1) {}
+
+bool MappedFile::open(const char* fileName) {
+	close();
+	fd = ::open(fileName, O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		close();
+		return false;
+	}
+	size_ = (size_t)st.st_size;
+	if (size_ == 0) {
+		return true;
+	}
+
+	void* mapped = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (mapped == MAP_FAILED) {
+		close();
+		return false;
+	}
+	data_ = (const char*)mapped;
+	return true;
+}
+
+void MappedFile::close() {
+	if (data_ != nullptr) {
+		munmap((void*)data_, size_);
+	}
+	if (fd >= 0) {
+		::close(fd);
+	}
+	data_ = nullptr;
+	size_ = 0;
+	fd = -1;
+}
+
+bool MappedFile::isOpen() const {
+	return fd >= 0;
+}
+
+#endif
+
+MappedFile::~MappedFile() {
+	close();
+}
+
+const char* MappedFile::data() const {
+	return data_;
+}
+
+size_t MappedFile::size() const {
+	return size_;
+}
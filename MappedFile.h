@@ -0,0 +1,65 @@
+﻿#pragma once
+#include <cstddef>
+
+/**
+ * 只读内存映射文件。Windows 下使用 CreateFileMapping/MapViewOfFile，其他平台使用 mmap。
+ */
+class MappedFile {
+private:
+	const char* data_; // 映射区域的起始地址
+	size_t size_; // 文件大小
+#ifdef _WIN32
+	void* fileHandle; // 文件句柄
+	void* mappingHandle; // 映射对象句柄
+#else
+	int fd; // 文件描述符
+#endif
+
+public:
+	/**
+	 * 默认构造函数，创建一个未打开的映射。
+	 */
+	MappedFile();
+
+	/**
+	 * 析构函数，解除映射并关闭文件。
+	 */
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	/**
+	 * 以只读方式映射整个文件。
+	 *
+	 * @param fileName 文件名
+	 * @return 映射成功返回 true，否则返回 false
+	 */
+	bool open(const char* fileName);
+
+	/**
+	 * 解除映射并关闭文件。
+	 */
+	void close();
+
+	/**
+	 * 检查文件是否已打开。
+	 *
+	 * @return 已打开返回 true，否则返回 false
+	 */
+	bool isOpen() const;
+
+	/**
+	 * 获取映射区域的起始地址。
+	 *
+	 * @return 起始地址，空文件时为 nullptr
+	 */
+	const char* data() const;
+
+	/**
+	 * 获取文件大小。
+	 *
+	 * @return 文件大小（字节）
+	 */
+	size_t size() const;
+};
@@ -0,0 +1,187 @@
+﻿#include <queue>
+#include <unordered_set>
+#include <vector>
+
+#include "MultiAgentPlanner.h"
+
+typedef MultiAgentPlanner::Position Position;
+
+MultiAgentPlanner::MultiAgentPlanner(int boardSize_, int maxWait_)
+	: boardSize(boardSize_), maxWait(maxWait_), cellCount((size_t)boardSize_ * boardSize_), expanded(0) {
+}
+
+bool MultiAgentPlanner::isValid(int x, int y) const {
+	return x >= 1 && x <= boardSize && y >= 1 && y <= boardSize;
+}
+
+size_t MultiAgentPlanner::cellIndex(int x, int y) const {
+	return (size_t)(x - 1) * boardSize + (y - 1);
+}
+
+Position MultiAgentPlanner::cellPosition(size_t cell) const {
+	return Position((int)(cell / boardSize) + 1, (int)(cell % boardSize) + 1);
+}
+
+size_t MultiAgentPlanner::expandedNodes() const {
+	return expanded;
+}
+
+/**
+ * 检查格子在某一时刻是否已被优先级更高的马占用（经过或停在终点）。
+ */
+bool MultiAgentPlanner::isOccupied(size_t cell, int time) const {
+	if (reserved.count((unsigned long long)time * cellCount + cell)) {
+		return true;
+	}
+	std::unordered_map<size_t, int>::const_iterator parked = parkedFrom.find(cell);
+	return parked != parkedFrom.end() && time >= parked->second;
+}
+
+/**
+ * 检查从 from 在 time 时刻走到 to 是否会与某个马在同一步互换位置。
+ */
+bool MultiAgentPlanner::isSwap(size_t from, size_t to, int time) const {
+	std::unordered_map<unsigned long long, int>::const_iterator before = reserved.find((unsigned long long)time * cellCount + to);
+	if (before == reserved.end()) {
+		return false;
+	}
+	std::unordered_map<unsigned long long, int>::const_iterator after = reserved.find((unsigned long long)(time + 1) * cellCount + from);
+	return after != reserved.end() && after->second == before->second;
+}
+
+/**
+ * 在 (格子, 时刻) 空间中为单个马做 A* 搜索。
+ * f 相同时优先展开时刻大的节点，使搜索尽快沿一条路径推进到终点。
+ */
+bool MultiAgentPlanner::planAgent(const Position& start, const Position& goal, Vector<Position>& path) {
+	typedef std::pair<std::pair<int, int>, int> OpenEntry; // ((f, -时刻), 节点下标)
+	std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry> > open;
+	std::unordered_set<unsigned long long> closed;
+
+	size_t startCell = cellIndex(start.x, start.y);
+	size_t goalCell = cellIndex(goal.x, goal.y);
+	if (isOccupied(startCell, 0) || parkedFrom.count(goalCell)) {
+		return false;
+	}
+
+	// 终点必须在所有更高优先级的马最后一次经过之后才能停下
+	int earliestPark = 0;
+	std::unordered_map<size_t, int>::const_iterator last = lastReserved.find(goalCell);
+	if (last != lastReserved.end()) {
+		earliestPark = last->second + 1;
+	}
+	int horizon = Chessboard::knightLowerBound(goal.x - start.x, goal.y - start.y) + maxWait;
+	if (earliestPark > horizon) {
+		horizon = earliestPark;
+	}
+
+	nodes.resize(0);
+	Node root = { startCell, 0, -1 };
+	nodes.push_back(root);
+	open.push(OpenEntry(std::make_pair(Chessboard::knightLowerBound(goal.x - start.x, goal.y - start.y), 0), 0));
+
+	while (!open.empty()) {
+		int curr = open.top().second;
+		open.pop();
+		Node node = nodes[curr];
+		unsigned long long key = (unsigned long long)node.time * cellCount + node.cell;
+		if (!closed.insert(key).second) {
+			continue;
+		}
+		expanded++;
+
+		if (node.cell == goalCell && node.time >= earliestPark) {
+			path = Vector<Position>();
+			for (int i = curr; i != -1; i = nodes[i].parent) {
+				path.push_back(cellPosition(nodes[i].cell));
+			}
+			return true;
+		}
+		if (node.time >= horizon) {
+			continue;
+		}
+
+		Position pos = cellPosition(node.cell);
+		int nextTime = node.time + 1;
+		for (int i = 0; i <= 8; i++) {
+			// 下标 8 表示原地等待一步
+			int nextX = i < 8 ? pos.x + Chessboard::dx[i] : pos.x;
+			int nextY = i < 8 ? pos.y + Chessboard::dy[i] : pos.y;
+			if (!isValid(nextX, nextY)) {
+				continue;
+			}
+			size_t nextCell = cellIndex(nextX, nextY);
+			if (closed.count((unsigned long long)nextTime * cellCount + nextCell) ||
+				isOccupied(nextCell, nextTime) || isSwap(node.cell, nextCell, node.time)) {
+				continue;
+			}
+			int estimate = nextTime + Chessboard::knightLowerBound(goal.x - nextX, goal.y - nextY);
+			if (estimate > horizon) {
+				continue;
+			}
+			Node child = { nextCell, nextTime, curr };
+			nodes.push_back(child);
+			open.push(OpenEntry(std::make_pair(estimate, -nextTime), (int)nodes.size() - 1));
+		}
+	}
+	return false;
+}
+
+/**
+ * 把一个马的路径写入预约表，path 终点在前，时刻 t 的位置为 path[path.size() - 1 - t]。
+ */
+void MultiAgentPlanner::reserve(const Vector<Position>& path, int agent) {
+	int arrival = (int)path.size() - 1;
+	for (int t = 0; t <= arrival; t++) {
+		const Position& pos = path[arrival - t];
+		size_t cell = cellIndex(pos.x, pos.y);
+		reserved[(unsigned long long)t * cellCount + cell] = agent;
+		int& latest = lastReserved.insert(std::make_pair(cell, t)).first->second;
+		if (t > latest) {
+			latest = t;
+		}
+	}
+	parkedFrom[cellIndex(path[0].x, path[0].y)] = arrival;
+}
+
+bool MultiAgentPlanner::plan(const Vector<Position>& starts, const Vector<Position>& goals, Vector<Vector<Position>>& paths) {
+	reserved.clear();
+	parkedFrom.clear();
+	lastReserved.clear();
+	paths = Vector<Vector<Position>>();
+	expanded = 0;
+
+	if (starts.size() != goals.size()) {
+		return false;
+	}
+	for (size_t i = 0; i < starts.size(); i++) {
+		if (!isValid(starts[i].x, starts[i].y) || !isValid(goals[i].x, goals[i].y)) {
+			return false;
+		}
+	}
+
+	// 所有马在 0 时刻都占着自己的起点，先全部预约，避免高优先级的马在 0 时刻踩到后面马的起点
+	for (size_t i = 0; i < starts.size(); i++) {
+		size_t cell = cellIndex(starts[i].x, starts[i].y);
+		if (!reserved.insert(std::make_pair((unsigned long long)cell, (int)i)).second) {
+			return false;
+		}
+		lastReserved[cell] = 0;
+	}
+
+	for (size_t i = 0; i < starts.size(); i++) {
+		reserved.erase((unsigned long long)cellIndex(starts[i].x, starts[i].y));
+		Vector<Position> path;
+		if (!planAgent(starts[i], goals[i], path)) {
+			return false;
+		}
+		reserve(path, (int)i);
+		paths.push_back(path);
+	}
+	return true;
+}
+
+Position MultiAgentPlanner::positionAt(const Vector<Position>& path, int time) {
+	int arrival = (int)path.size() - 1;
+	return time >= arrival ? path[0] : path[arrival - time];
+}
@@ -0,0 +1,79 @@
+﻿#pragma once
+#include <unordered_map>
+#include "Chessboard.h"
+#include "Vector.h"
+
+/**
+ * 多个马同时移动的路径规划器（按优先级的时空规划）。
+ *
+ * 按给定顺序依次为每个马在 (格子, 时刻) 空间中做 A* 搜索，除 8 种跳法外还允许原地等待一步，
+ * 已规划的马把经过的 (时刻, 格子) 写入预约表，后面的马必须避开：
+ * 同一时刻不能占用同一格子，也不能在同一步互换位置。马到达终点后停在终点，
+ * 因此终点格子从到达时刻起对后面的马一直不可用。
+ * 预约表是以 时刻 * 格子数 + 格子下标 为键的哈希表，内存只与所有路径的总长度成正比，与棋盘大小无关。
+ */
+class MultiAgentPlanner {
+public:
+	typedef Chessboard::Position Position;
+
+private:
+	struct Node {
+		size_t cell; // 格子下标
+		int time; // 时刻
+		int parent; // 父节点在 nodes 中的下标，起点为 -1
+	};
+
+	int boardSize; // 棋盘大小
+	int maxWait; // 每个马比无障碍下界最多多用的步数
+	size_t cellCount; // 格子总数
+	std::unordered_map<unsigned long long, int> reserved; // (时刻, 格子) -> 占用它的马
+	std::unordered_map<size_t, int> parkedFrom; // 终点格子 -> 马停留在该格子的起始时刻
+	std::unordered_map<size_t, int> lastReserved; // 格子 -> 被预约的最晚时刻
+	Vector<Node> nodes; // 单个马搜索时的节点池
+	size_t expanded; // 上一次 plan 展开的节点数
+
+public:
+	/**
+	 * 构造函数。
+	 *
+	 * @param boardSize_ 棋盘大小
+	 * @param maxWait_ 每个马的时间上限为 无障碍跳数下界 + maxWait_，超过则认为无解
+	 */
+	explicit MultiAgentPlanner(int boardSize_, int maxWait_ = 64);
+
+	/**
+	 * 按顺序为所有马规划互不冲突的路径，下标小的马优先级高。
+	 *
+	 * @param starts 每个马的起始位置
+	 * @param goals 每个马的目标位置
+	 * @param paths 输出，每个马按时刻排列的位置列表（与 Chessboard 各求解函数相同，终点在前），
+	 *              等待时同一位置会连续出现
+	 * @return 所有马都规划成功返回 true，否则返回 false（此时 paths 中只有已成功的部分）
+	 */
+	bool plan(const Vector<Position>& starts, const Vector<Position>& goals, Vector<Vector<Position>>& paths);
+
+	/**
+	 * 获取马在某一时刻的位置，到达终点后一直停在终点。
+	 *
+	 * @param path plan 输出的单个马的路径
+	 * @param time 时刻，从 0 开始
+	 * @return 该时刻所在的位置
+	 */
+	static Position positionAt(const Vector<Position>& path, int time);
+
+	/**
+	 * 获取上一次 plan 调用中所有马一共展开的节点数。
+	 *
+	 * @return 展开的节点数
+	 */
+	size_t expandedNodes() const;
+
+private:
+	bool isValid(int x, int y) const;
+	size_t cellIndex(int x, int y) const;
+	Position cellPosition(size_t cell) const;
+	bool isOccupied(size_t cell, int time) const;
+	bool isSwap(size_t from, size_t to, int time) const;
+	bool planAgent(const Position& start, const Position& goal, Vector<Position>& path);
+	void reserve(const Vector<Position>& path, int agent);
+};
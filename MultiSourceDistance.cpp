@@ -0,0 +1,154 @@
+﻿#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include "MultiSourceDistance.h"
+
+typedef MultiSourceDistance::Position Position;
+
+const int MultiSourceDistance::MAX_SOURCES;
+
+/**
+ * 返回 64 位字最低位 1 的下标，参数不能为 0。
+ */
+static inline int lowestBit(unsigned long long word) {
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward64(&index, word);
+	return (int)index;
+#else
+	return __builtin_ctzll(word);
+#endif
+}
+
+MultiSourceDistance::MultiSourceDistance(int boardSize_) : boardSize(boardSize_), sourceCount(0) {}
+
+bool MultiSourceDistance::compute(const Vector<Position>& sources) {
+	sourceCount = 0;
+	distances = Vector<unsigned short>();
+	if (sources.size() > MAX_SOURCES) {
+		return false;
+	}
+	for (int s = 0; s < sources.size(); s++) {
+		if (sources[s].x < 1 || sources[s].x > boardSize || sources[s].y < 1 || sources[s].y > boardSize) {
+			return false;
+		}
+	}
+
+	sourceCount = (int)sources.size();
+	size_t cells = (size_t)boardSize * boardSize;
+	distances = Vector<unsigned short>(cells * sourceCount, Chessboard::UNREACHED);
+	if (sourceCount == 0) {
+		return true;
+	}
+
+	// 带 2 格边框的位图，格子 (x, y) 位于 (x + 1) * width + (y + 1)
+	const int width = boardSize + 4;
+	size_t padded = (size_t)width * width;
+	Vector<unsigned long long> visitedWords(padded, 0);
+	Vector<unsigned long long> frontierWords(padded, 0);
+	Vector<unsigned long long> nextWords(padded, 0);
+	unsigned long long* visited = visitedWords.begin();
+	unsigned long long* frontier = frontierWords.begin();
+	unsigned long long* next = nextWords.begin();
+	unsigned short* dist = distances.begin();
+
+	// 每行是否含有非零字，用于跳过远离前沿的行
+	Vector<unsigned char> frontierRowsActive(width, 0);
+	Vector<unsigned char> nextRowsActive(width, 0);
+	unsigned char* frontierRows = frontierRowsActive.begin();
+	unsigned char* nextRows = nextRowsActive.begin();
+
+	for (int s = 0; s < sourceCount; s++) {
+		size_t idx = (size_t)(sources[s].x + 1) * width + (sources[s].y + 1);
+		frontierRows[sources[s].x + 1] = 1;
+		frontier[idx] |= 1ULL << s;
+		visited[idx] |= 1ULL << s;
+		dist[s * cells + (size_t)(sources[s].x - 1) * boardSize + (sources[s].y - 1)] = 0;
+	}
+
+	// 马的 8 种走法在带边框位图中的下标偏移
+	const long long offsets[8] = {
+		-2LL * width - 1, -2LL * width + 1, -1LL * width - 2, -1LL * width + 2,
+		1LL * width - 2, 1LL * width + 2, 2LL * width - 1, 2LL * width + 1
+	};
+
+	for (unsigned short layer = 1; ; layer++) {
+		unsigned long long any = 0;
+		for (int x = 1; x <= boardSize; x++) {
+			size_t rowBegin = (size_t)(x + 1) * width + 2;
+			unsigned long long* out = next + rowBegin;
+			const unsigned char* near = frontierRows + x - 1;
+			if (!(near[0] | near[1] | near[3] | near[4])) {
+				// 上下两行内都没有前沿，本行不会有新到达的格子；清掉两层之前留下的旧数据
+				if (nextRows[x + 1]) {
+					for (int y = 0; y < boardSize; y++) {
+						out[y] = 0;
+					}
+					nextRows[x + 1] = 0;
+				}
+				continue;
+			}
+			const unsigned long long* seen = visited + rowBegin;
+			const unsigned long long* f0 = frontier + rowBegin + offsets[0];
+			const unsigned long long* f1 = frontier + rowBegin + offsets[1];
+			const unsigned long long* f2 = frontier + rowBegin + offsets[2];
+			const unsigned long long* f3 = frontier + rowBegin + offsets[3];
+			const unsigned long long* f4 = frontier + rowBegin + offsets[4];
+			const unsigned long long* f5 = frontier + rowBegin + offsets[5];
+			const unsigned long long* f6 = frontier + rowBegin + offsets[6];
+			const unsigned long long* f7 = frontier + rowBegin + offsets[7];
+
+			// 行内核：连续内存上的按位运算，无分支
+			unsigned long long rowAny = 0;
+			for (int y = 0; y < boardSize; y++) {
+				unsigned long long reached = (f0[y] | f1[y] | f2[y] | f3[y] | f4[y] | f5[y] | f6[y] | f7[y]) & ~seen[y];
+				out[y] = reached;
+				rowAny |= reached;
+			}
+			nextRows[x + 1] = rowAny != 0;
+			if (rowAny == 0) {
+				continue;
+			}
+			any |= rowAny;
+
+			// 记录本层新到达的格子
+			unsigned long long* seenRow = visited + rowBegin;
+			size_t cellBegin = (size_t)(x - 1) * boardSize;
+			for (int y = 0; y < boardSize; y++) {
+				unsigned long long reached = out[y];
+				seenRow[y] |= reached;
+				while (reached != 0) {
+					int s = lowestBit(reached);
+					dist[s * cells + cellBegin + y] = layer;
+					reached &= reached - 1;
+				}
+			}
+		}
+		if (any == 0) {
+			break;
+		}
+
+		unsigned long long* swap = frontier;
+		frontier = next;
+		next = swap;
+		unsigned char* swapRows = frontierRows;
+		frontierRows = nextRows;
+		nextRows = swapRows;
+	}
+
+	return true;
+}
+
+int MultiSourceDistance::sources() const {
+	return sourceCount;
+}
+
+const unsigned short* MultiSourceDistance::field(int source) const {
+	return distances.begin() + (size_t)source * boardSize * boardSize;
+}
+
+int MultiSourceDistance::distance(int source, const Position& cell) const {
+	unsigned short jumps = field(source)[(size_t)(cell.x - 1) * boardSize + (cell.y - 1)];
+	return jumps == Chessboard::UNREACHED ? -1 : jumps;
+}
@@ -0,0 +1,63 @@
+﻿#pragma once
+#include "Chessboard.h"
+#include "Vector.h"
+
+/**
+ * 多源距离引擎：同时计算最多 64 个起点到棋盘上所有格子的跳数。
+ *
+ * 每个格子用一个 64 位字表示各起点的访问状态（一位对应一个起点），
+ * 整张棋盘的边界外再留出 2 格全零的边框，这样一层扩展只是对每行做 8 次带偏移的按位或，
+ * 行内循环连续、无分支，编译器可以自动向量化。一次扩展同时推进所有起点，
+ * 每层的代价与棋盘面积成正比，因此起点较多、棋盘边长不太大时（例如 64 个起点、边长 512 以内）
+ * 比逐个起点调用 minJumpsBFS 或 distanceField 快数倍。
+ */
+class MultiSourceDistance {
+public:
+	typedef Chessboard::Position Position;
+	static const int MAX_SOURCES = 64;
+
+private:
+	int boardSize; // 棋盘大小
+	int sourceCount; // 起点个数
+	Vector<unsigned short> distances; // 各起点的距离场，依次排列
+
+public:
+	/**
+	 * 构造函数。
+	 *
+	 * @param boardSize_ 棋盘大小
+	 */
+	explicit MultiSourceDistance(int boardSize_);
+
+	/**
+	 * 计算各起点的距离场。
+	 *
+	 * @param sources 起点列表（不超过 MAX_SOURCES 个）
+	 * @return 计算成功返回 true，起点过多或坐标非法时返回 false
+	 */
+	bool compute(const Vector<Position>& sources);
+
+	/**
+	 * 获取起点个数。
+	 *
+	 * @return 上一次 compute 的起点个数
+	 */
+	int sources() const;
+
+	/**
+	 * 获取某个起点的距离场，排列方式与 Chessboard::distanceField 相同，未到达的格子为 Chessboard::UNREACHED。
+	 *
+	 * @param source 起点下标
+	 * @return 距离场起始地址
+	 */
+	const unsigned short* field(int source) const;
+
+	/**
+	 * 查询某个起点到某个格子的跳数。
+	 *
+	 * @param source 起点下标
+	 * @param cell 格子位置
+	 * @return 跳数，不可达时返回 -1
+	 */
+	int distance(int source, const Position& cell) const;
+};
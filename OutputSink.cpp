@@ -0,0 +1,198 @@
+﻿#include <ostream>
+#include <cstring>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+
+#include "OutputSink.h"
+
+/**
+ * OutputSink 替换进输出流的 streambuf。当前块就是 streambuf 的写入区，
+ * 写满（overflow）或同步（sync，例如 endl 或 flush）时把整块交出：同步模式直接写入目标，
+ * 异步模式放入队列由写线程写出，并从空闲列表中取一块继续写，块在两个线程之间循环使用。
+ * 目标写入不完整（sputn 返回值小于块大小）或刷新失败后记为失败，之后的内容都被丢弃，
+ * overflow 返回 eof、sync 返回 -1，使外层的流置上 badbit。
+ */
+class SinkBuffer : public std::streambuf {
+private:
+	static const size_t MAX_PENDING = 8; // 队列中最多等待写出的块数
+
+	std::streambuf* target; // 真正的写出目标
+	bool async; // 是否由写线程写出
+	size_t blockSize; // 块大小
+	std::vector<char> current; // 当前写入的块
+
+	std::thread writer; // 写线程
+	std::mutex mutex;
+	std::condition_variable changed; // 队列或写线程状态变化
+	std::deque<std::vector<char> > pending; // 等待写出的块
+	std::vector<std::vector<char> > spare; // 已写出、可以复用的块
+	bool writing; // 写线程是否正在写出一块
+	bool stopping; // 是否通知写线程退出
+	std::atomic<bool> failed; // 是否有写入失败
+
+public:
+	SinkBuffer(std::streambuf* target_, bool async_, size_t blockSize_)
+		: target(target_), async(async_), blockSize(blockSize_ > 0 ? blockSize_ : 1), current(blockSize),
+		writing(false), stopping(false), failed(false) {
+		setp(current.data(), current.data() + blockSize);
+		if (async) {
+			writer = std::thread(&SinkBuffer::writeLoop, this);
+		}
+	}
+
+	~SinkBuffer() {
+		drain();
+		if (async) {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				stopping = true;
+			}
+			changed.notify_all();
+			writer.join();
+		}
+	}
+
+	/**
+	 * 交出当前块并等待所有块写完，然后刷新目标。
+	 *
+	 * @return 到目前为止的所有内容都写出成功返回 true，否则返回 false
+	 */
+	bool drain() {
+		handOff();
+		if (async) {
+			std::unique_lock<std::mutex> lock(mutex);
+			changed.wait(lock, [this]() { return pending.empty() && !writing; });
+		}
+		if (!failed && target->pubsync() == -1) {
+			failed = true;
+		}
+		return !failed;
+	}
+
+protected:
+	int_type overflow(int_type c) override {
+		if (!handOff()) {
+			return traits_type::eof();
+		}
+		if (!traits_type::eq_int_type(c, traits_type::eof())) {
+			*pptr() = traits_type::to_char_type(c);
+			pbump(1);
+		}
+		return traits_type::not_eof(c);
+	}
+
+	std::streamsize xsputn(const char* s, std::streamsize n) override {
+		std::streamsize left = n;
+		while (left > 0) {
+			std::streamsize space = epptr() - pptr();
+			if (space == 0) {
+				if (!handOff()) {
+					return n - left;
+				}
+				space = epptr() - pptr();
+			}
+			std::streamsize take = left < space ? left : space;
+			memcpy(pptr(), s, (size_t)take);
+			pbump((int)take);
+			s += take;
+			left -= take;
+		}
+		return n;
+	}
+
+	int sync() override {
+		return handOff() ? 0 : -1;
+	}
+
+private:
+	/**
+	 * 交出当前块中已写入的内容。已经失败时直接丢弃。
+	 *
+	 * @return 没有发生过写入失败返回 true（异步模式下只反映已经写完的块）
+	 */
+	bool handOff() {
+		size_t used = (size_t)(pptr() - pbase());
+		if (failed) {
+			setp(current.data(), current.data() + blockSize);
+			return false;
+		}
+		if (used == 0) {
+			return true;
+		}
+		if (!async) {
+			if (target->sputn(pbase(), (std::streamsize)used) != (std::streamsize)used) {
+				failed = true;
+			}
+			setp(current.data(), current.data() + blockSize);
+			return !failed;
+		}
+
+		std::unique_lock<std::mutex> lock(mutex);
+		changed.wait(lock, [this]() { return pending.size() < MAX_PENDING; });
+		current.resize(used);
+		pending.push_back(std::move(current));
+		if (!spare.empty()) {
+			current = std::move(spare.back());
+			spare.pop_back();
+		} else {
+			current = std::vector<char>();
+		}
+		lock.unlock();
+		changed.notify_all();
+
+		current.resize(blockSize);
+		setp(current.data(), current.data() + blockSize);
+		return !failed;
+	}
+
+	void writeLoop() {
+		std::unique_lock<std::mutex> lock(mutex);
+		while (true) {
+			changed.wait(lock, [this]() { return !pending.empty() || stopping; });
+			if (pending.empty()) {
+				return;
+			}
+			std::vector<char> block = std::move(pending.front());
+			pending.pop_front();
+			writing = true;
+			lock.unlock();
+
+			// 失败后不再尝试写出，只把块放回空闲列表
+			if (!failed && target->sputn(block.data(), (std::streamsize)block.size()) != (std::streamsize)block.size()) {
+				failed = true;
+			}
+
+			lock.lock();
+			spare.push_back(std::move(block));
+			writing = false;
+			changed.notify_all();
+		}
+	}
+};
+
+const size_t SinkBuffer::MAX_PENDING;
+
+OutputSink::OutputSink(std::ostream& stream_, bool async, size_t blockSize)
+	: stream(stream_), original(stream_.rdbuf()), buffer(new SinkBuffer(stream_.rdbuf(), async, blockSize)) {
+	stream.rdbuf(buffer.get());
+}
+
+OutputSink::~OutputSink() {
+	bool ok = buffer->drain();
+	stream.rdbuf(original);
+	if (!ok) {
+		stream.setstate(std::ios::badbit);
+	}
+}
+
+bool OutputSink::flush() {
+	if (!buffer->drain()) {
+		stream.setstate(std::ios::badbit);
+		return false;
+	}
+	return true;
+}
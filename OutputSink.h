@@ -0,0 +1,48 @@
+﻿#pragma once
+#include <iosfwd>
+#include <memory>
+
+class SinkBuffer;
+
+/**
+ * 大块缓冲的输出。构造时接管一个输出流（例如 cout）的 rdbuf，期间写入该流的内容先收集到
+ * 固定大小的块中，块满或显式刷新时才整块写出，换行不会触发写出；析构时写出剩余内容并恢复原来的 rdbuf。
+ *
+ * 打开异步模式后，写满的块交给后台写线程写出，计算线程只做内存复制。排队的块数有上限，
+ * 写线程跟不上时计算线程会等待，内存占用不会无限增长。
+ *
+ * 写出失败（例如磁盘已满）时被接管的流会被置上 badbit，调用方照常用 !stream 检查，包括在 OutputSink 析构之后。
+ *
+ * 与 TextBuffer 配合使用：TextBuffer 把一条结果格式化后一次写入流，OutputSink 决定何时、由哪个线程真正写出。
+ */
+class OutputSink {
+private:
+	std::ostream& stream; // 被接管的输出流
+	std::streambuf* original; // 原来的 rdbuf，真正的写出目标
+	std::unique_ptr<SinkBuffer> buffer; // 替换进去的缓冲区
+
+public:
+	/**
+	 * 构造函数，接管输出流。
+	 *
+	 * @param stream_ 输出流
+	 * @param async 是否由后台线程写出
+	 * @param blockSize 缓冲块大小（字节）
+	 */
+	OutputSink(std::ostream& stream_, bool async = false, size_t blockSize = 1 << 16);
+
+	/**
+	 * 析构函数，写出剩余内容，等待写线程结束并恢复原来的 rdbuf。有内容没能写出时给流置上 badbit。
+	 */
+	~OutputSink();
+
+	OutputSink(const OutputSink&) = delete;
+	OutputSink& operator=(const OutputSink&) = delete;
+
+	/**
+	 * 写出已缓冲的内容并等待全部写完（例如打开会阻塞的图像窗口之前）。
+	 *
+	 * @return 全部写出成功返回 true；失败时返回 false，并给流置上 badbit
+	 */
+	bool flush();
+};
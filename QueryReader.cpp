@@ -0,0 +1,143 @@
+﻿#include <fstream>
+#include <cstring>
+
+#include "QueryReader.h"
+#include "BinaryFormat.h"
+
+QueryReader::QueryReader()
+	: cursor(nullptr), end(nullptr), records(nullptr), remaining(0), binary(false), boardSize_(0), error(nullptr) {
+}
+
+bool QueryReader::open(const char* fileName) {
+	cursor = end = nullptr;
+	records = nullptr;
+	remaining = 0;
+	binary = false;
+	boardSize_ = 0;
+	error = nullptr;
+	if (!file.open(fileName)) {
+		return false;
+	}
+
+	const char* data = file.data();
+	size_t size = file.size();
+	if (size >= 4 && memcmp(data, BINARY_MAGIC, 4) == 0) {
+		const BinaryHeader* header = binaryHeader(data, size, BINARY_KIND_QUERIES);
+		if (header == nullptr || header->boardSize > (uint32_t)Chessboard::MAX_BOARD_SIZE) {
+			return false;
+		}
+		binary = true;
+		boardSize_ = (int)header->boardSize;
+		records = (const int32_t*)(data + sizeof(BinaryHeader));
+		remaining = header->count;
+		return true;
+	}
+
+	cursor = data;
+	end = data + size;
+	// 跳过 UTF-8 BOM
+	if (size >= 3 && memcmp(data, "\xEF\xBB\xBF", 3) == 0) {
+		cursor += 3;
+	}
+	return true;
+}
+
+/**
+ * 跳过空白后解析一个十进制整数（可带负号）。只有空白之后直接到达文件末尾时才是正常结束，
+ * 其余失败都把当前数的起始位置记入 error。
+ */
+bool QueryReader::nextInt(int& value) {
+	while (cursor != end && (*cursor == ' ' || *cursor == '\n' || *cursor == '\r' || *cursor == '\t')) {
+		cursor++;
+	}
+	if (cursor == end) {
+		return false;
+	}
+	const char* token = cursor;
+	bool negative = *cursor == '-';
+	if (negative) {
+		cursor++;
+	}
+	if (cursor == end || (unsigned)(*cursor - '0') > 9) {
+		error = token;
+		return false;
+	}
+	long long result = 0;
+	while (cursor != end && (unsigned)(*cursor - '0') <= 9) {
+		result = result * 10 + (*cursor - '0');
+		if (result > INT32_MAX) {
+			error = token;
+			return false;
+		}
+		cursor++;
+	}
+	value = (int)(negative ? -result : result);
+	return true;
+}
+
+bool QueryReader::next(Query& query) {
+	if (binary) {
+		if (remaining == 0) {
+			return false;
+		}
+		query.start = Chessboard::Position(records[0], records[1]);
+		query.target = Chessboard::Position(records[2], records[3]);
+		query.boardSize = boardSize_;
+		records += 4;
+		remaining--;
+		return true;
+	}
+	query.boardSize = 0;
+	if (error != nullptr || !nextInt(query.start.x)) {
+		return false;
+	}
+	if (nextInt(query.start.y) && nextInt(query.target.x) && nextInt(query.target.y)) {
+		return true;
+	}
+	// 查询读到一半就到了文件末尾
+	if (error == nullptr) {
+		error = end;
+	}
+	return false;
+}
+
+bool QueryReader::failed() const {
+	return error != nullptr;
+}
+
+size_t QueryReader::errorOffset() const {
+	return error != nullptr ? (size_t)(error - file.data()) : 0;
+}
+
+size_t QueryReader::errorLine() const {
+	if (error == nullptr) {
+		return 0;
+	}
+	size_t line = 1;
+	for (const char* p = file.data(); p != error; p++) {
+		line += *p == '\n';
+	}
+	return line;
+}
+
+bool QueryReader::isBinary() const {
+	return binary;
+}
+
+int QueryReader::boardSize() const {
+	return boardSize_;
+}
+
+bool QueryReader::writeBinary(const Vector<Query>& queries, int boardSize, const char* fileName) {
+	std::ofstream outputFile(fileName, std::ios::binary);
+	if (!outputFile.is_open()) {
+		return false;
+	}
+	BinaryHeader header = makeBinaryHeader(BINARY_KIND_QUERIES, boardSize, 0, 0, 0, 0, (uint32_t)queries.size());
+	outputFile.write((const char*)&header, sizeof(header));
+	for (size_t i = 0; i < queries.size(); i++) {
+		int32_t record[4] = { queries[i].start.x, queries[i].start.y, queries[i].target.x, queries[i].target.y };
+		outputFile.write((const char*)record, sizeof(record));
+	}
+	return outputFile.good();
+}
@@ -0,0 +1,101 @@
+﻿#pragma once
+#include <cstdint>
+#include "Chessboard.h"
+#include "MappedFile.h"
+#include "Vector.h"
+
+/**
+ * 一个查询：起始位置、目标位置和棋盘大小。
+ */
+struct Query {
+	Chessboard::Position start;
+	Chessboard::Position target;
+	int boardSize; // 棋盘大小，0 表示未指定（由调用方决定）
+};
+
+/**
+ * 批量查询文件的读取器。文件通过内存映射打开，next 每次取出一个查询，不分配内存。
+ *
+ * 支持两种格式，打开时按文件头自动识别：
+ * - 文本：与 input.txt 相同，每个查询 4 个整数，以任意空白分隔，用手写的整数扫描器解析，不经过 iostream。
+ * - 二进制：BinaryFormat.h 中 kind 为 BINARY_KIND_QUERIES 的文件，负载可以直接当作 int32 数组读取，
+ *   文件头中的棋盘大小填入每个查询。
+ */
+class QueryReader {
+private:
+	MappedFile file; // 映射的查询文件
+	const char* cursor; // 文本格式的当前读取位置
+	const char* end; // 文本格式的结束位置
+	const int32_t* records; // 二进制格式的下一个查询
+	size_t remaining; // 二进制格式剩余的查询数
+	bool binary; // 是否为二进制格式
+	int boardSize_; // 二进制文件头中的棋盘大小，文本格式为 0
+	const char* error; // 文本格式中解析失败的位置，没有失败时为 nullptr
+
+public:
+	/**
+	 * 默认构造函数，创建一个未打开的读取器。
+	 */
+	QueryReader();
+
+	/**
+	 * 打开查询文件并识别格式。
+	 *
+	 * @param fileName 文件名
+	 * @return 打开成功返回 true；文件不存在、二进制文件头不完整或其中的棋盘大小超过 Chessboard::MAX_BOARD_SIZE 时返回 false
+	 */
+	bool open(const char* fileName);
+
+	/**
+	 * 读取下一个查询。
+	 *
+	 * @param query 输出，读到的查询
+	 * @return 读到完整的查询返回 true；文件结束、遇到非数字内容或最后一个查询不完整时返回 false，
+	 *         后两种情况可以用 failed 与正常结束区分
+	 */
+	bool next(Query& query);
+
+	/**
+	 * 检查文本格式的解析是否在文件结束前停止（非数字内容、超出 int 范围的数或不完整的查询）。
+	 */
+	bool failed() const;
+
+	/**
+	 * 获取解析失败处的字节偏移（从文件开头算起）。
+	 *
+	 * @return 字节偏移，没有失败时为 0
+	 */
+	size_t errorOffset() const;
+
+	/**
+	 * 获取解析失败处的行号（从 1 开始），只在失败后逐字节计算一次。
+	 *
+	 * @return 行号，没有失败时为 0
+	 */
+	size_t errorLine() const;
+
+	/**
+	 * 检查打开的是否为二进制格式。
+	 */
+	bool isBinary() const;
+
+	/**
+	 * 获取二进制文件头中记录的棋盘大小。
+	 *
+	 * @return 棋盘大小，文本格式或未指定时为 0
+	 */
+	int boardSize() const;
+
+	/**
+	 * 以二进制格式保存查询。
+	 *
+	 * @param queries 查询列表
+	 * @param boardSize 棋盘大小，0 表示不指定
+	 * @param fileName 输出文件名
+	 * @return 写入成功返回 true，否则返回 false
+	 */
+	static bool writeBinary(const Vector<Query>& queries, int boardSize, const char* fileName);
+
+private:
+	bool nextInt(int& value);
+};
@@ -1,10 +1,10 @@
 ﻿#pragma once
 #include "List.h"
 
-template <typename T>
+template <typename T, typename Alloc = DefaultAllocator>
 class Queue {
 private:
-    List<T> container; // 底层容器使用链表实现
+    List<T, Alloc> container; // 底层容器使用链表实现
 
 public:
     /**
@@ -48,33 +48,33 @@ public:
     size_t size() const;
 };
 
-template <typename T>
-void Queue<T>::push(const T& val) {
+template <typename T, typename Alloc>
+void Queue<T, Alloc>::push(const T& val) {
     container.push_back(val);
 }
 
-template <typename T>
-void Queue<T>::pop() {
+template <typename T, typename Alloc>
+void Queue<T, Alloc>::pop() {
     container.pop_front();
 }
 
-template <typename T>
-T& Queue<T>::front() {
+template <typename T, typename Alloc>
+T& Queue<T, Alloc>::front() {
     return container.front();
 }
 
-template <typename T>
-const T& Queue<T>::front() const {
+template <typename T, typename Alloc>
+const T& Queue<T, Alloc>::front() const {
     return container.front();
 }
 
-template <typename T>
-bool Queue<T>::empty() const {
+template <typename T, typename Alloc>
+bool Queue<T, Alloc>::empty() const {
     return container.empty();
 }
 
-template <typename T>
-size_t Queue<T>::size() const {
+template <typename T, typename Alloc>
+size_t Queue<T, Alloc>::size() const {
     return container.size();
 }
 
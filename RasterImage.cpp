@@ -0,0 +1,247 @@
+﻿#include <fstream>
+#include <cstring>
+#include <cstdint>
+
+#include "RasterImage.h"
+
+RasterImage::RasterImage(int width, int height, unsigned char r, unsigned char g, unsigned char b)
+	: width_(width > 0 ? width : 0), height_(height > 0 ? height : 0),
+	pixels((size_t)(width > 0 ? width : 0) * (height > 0 ? height : 0) * 3, 0) {
+	unsigned char* p = pixels.begin();
+	size_t count = (size_t)width_ * height_;
+	for (size_t i = 0; i < count; i++) {
+		p[3 * i] = r;
+		p[3 * i + 1] = g;
+		p[3 * i + 2] = b;
+	}
+}
+
+int RasterImage::width() const {
+	return width_;
+}
+
+int RasterImage::height() const {
+	return height_;
+}
+
+unsigned char* RasterImage::data() {
+	return pixels.begin();
+}
+
+const unsigned char* RasterImage::data() const {
+	return pixels.begin();
+}
+
+void RasterImage::fillRect(int x, int y, int w, int h, unsigned char r, unsigned char g, unsigned char b) {
+	int x0 = x < 0 ? 0 : x;
+	int y0 = y < 0 ? 0 : y;
+	int x1 = x + w > width_ ? width_ : x + w;
+	int y1 = y + h > height_ ? height_ : y + h;
+	unsigned char* p = pixels.begin();
+	for (int row = y0; row < y1; row++) {
+		unsigned char* px = p + ((size_t)row * width_ + x0) * 3;
+		for (int col = x0; col < x1; col++) {
+			px[0] = r;
+			px[1] = g;
+			px[2] = b;
+			px += 3;
+		}
+	}
+}
+
+void RasterImage::drawLine(int x0, int y0, int x1, int y1, unsigned char r, unsigned char g, unsigned char b) {
+	int dx = x1 > x0 ? x1 - x0 : x0 - x1;
+	int dy = y1 > y0 ? y0 - y1 : y1 - y0;
+	int sx = x0 < x1 ? 1 : -1;
+	int sy = y0 < y1 ? 1 : -1;
+	int err = dx + dy;
+	unsigned char* p = pixels.begin();
+	while (true) {
+		if (x0 >= 0 && x0 < width_ && y0 >= 0 && y0 < height_) {
+			unsigned char* px = p + ((size_t)y0 * width_ + x0) * 3;
+			px[0] = r;
+			px[1] = g;
+			px[2] = b;
+		}
+		if (x0 == x1 && y0 == y1) {
+			break;
+		}
+		int e2 = 2 * err;
+		if (e2 >= dy) {
+			err += dy;
+			x0 += sx;
+		}
+		if (e2 <= dx) {
+			err += dx;
+			y0 += sy;
+		}
+	}
+}
+
+bool RasterImage::writePPM(const char* fileName) const {
+	std::ofstream out(fileName, std::ios::binary);
+	if (!out.is_open()) {
+		return false;
+	}
+	out << "P6\n" << width_ << " " << height_ << "\n255\n";
+	out.write((const char*)pixels.begin(), (std::streamsize)pixels.size());
+	return (bool)out;
+}
+
+bool RasterImage::writePNG(const char* fileName) const {
+	std::ofstream out(fileName, std::ios::binary);
+	if (!out.is_open()) {
+		return false;
+	}
+	writePNGStream(out);
+	return (bool)out;
+}
+
+bool RasterImage::write(const char* fileName) const {
+	size_t length = strlen(fileName);
+	if (length >= 4 && (strcmp(fileName + length - 4, ".ppm") == 0 || strcmp(fileName + length - 4, ".PPM") == 0)) {
+		return writePPM(fileName);
+	}
+	return writePNG(fileName);
+}
+
+/**
+* PNG 块校验使用的 CRC-32 查找表，局部静态对象的初始化是线程安全的。
+*/
+struct CrcTable {
+	uint32_t entries[256];
+
+	CrcTable() {
+		for (uint32_t n = 0; n < 256; n++) {
+			uint32_t c = n;
+			for (int k = 0; k < 8; k++) {
+				c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+			}
+			entries[n] = c;
+		}
+	}
+};
+
+static const uint32_t* crcTable() {
+	static const CrcTable table;
+	return table.entries;
+}
+
+static uint32_t updateCrc(uint32_t crc, const unsigned char* data, size_t length) {
+	const uint32_t* table = crcTable();
+	for (size_t i = 0; i < length; i++) {
+		crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+	}
+	return crc;
+}
+
+static void putBigEndian(unsigned char* p, uint32_t value) {
+	p[0] = (unsigned char)(value >> 24);
+	p[1] = (unsigned char)(value >> 16);
+	p[2] = (unsigned char)(value >> 8);
+	p[3] = (unsigned char)value;
+}
+
+/**
+* 写出一个 PNG 块：长度、类型、数据和 CRC。
+*/
+static void writeChunk(std::ostream& out, const char* type, const unsigned char* data, uint32_t length) {
+	unsigned char header[8];
+	putBigEndian(header, length);
+	memcpy(header + 4, type, 4);
+	out.write((const char*)header, 8);
+	if (length > 0) {
+		out.write((const char*)data, length);
+	}
+
+	uint32_t crc = updateCrc(0xFFFFFFFFu, header + 4, 4);
+	crc = updateCrc(crc, data, length) ^ 0xFFFFFFFFu;
+	unsigned char trailer[4];
+	putBigEndian(trailer, crc);
+	out.write((const char*)trailer, 4);
+}
+
+/**
+* 把扫描线（每行一个过滤类型字节 0 加 RGB 数据）切成 deflate 存储块，每块单独写成一个 IDAT 块。
+* zlib 头和 Adler-32 校验也各自放在单独的 IDAT 块中，PNG 允许 zlib 流在 IDAT 之间任意切分。
+*/
+void RasterImage::writePNGStream(std::ostream& out) const {
+	static const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	out.write((const char*)signature, 8);
+
+	unsigned char ihdr[13];
+	putBigEndian(ihdr, (uint32_t)width_);
+	putBigEndian(ihdr + 4, (uint32_t)height_);
+	ihdr[8] = 8; // 位深度
+	ihdr[9] = 2; // 颜色类型：RGB
+	ihdr[10] = 0; // 压缩方法
+	ihdr[11] = 0; // 过滤方法
+	ihdr[12] = 0; // 不隔行
+	writeChunk(out, "IHDR", ihdr, 13);
+
+	static const unsigned char zlibHeader[2] = { 0x78, 0x01 };
+	writeChunk(out, "IDAT", zlibHeader, 2);
+
+	const size_t MAX_STORED = 65535;
+	size_t rowBytes = (size_t)width_ * 3 + 1;
+	size_t remaining = rowBytes * height_;
+	Vector<unsigned char> block(MAX_STORED + 5, 0);
+	unsigned char* buffer = block.begin();
+	uint32_t adlerA = 1;
+	uint32_t adlerB = 0;
+
+	// 当前行与行内偏移，偏移 0 是过滤类型字节
+	size_t row = 0;
+	size_t offset = 0;
+	const unsigned char* image = pixels.begin();
+	do {
+		size_t length = remaining < MAX_STORED ? remaining : MAX_STORED;
+		remaining -= length;
+		buffer[0] = remaining == 0 ? 1 : 0; // BFINAL，BTYPE = 00（存储）
+		buffer[1] = (unsigned char)length;
+		buffer[2] = (unsigned char)(length >> 8);
+		buffer[3] = (unsigned char)~length;
+		buffer[4] = (unsigned char)(~length >> 8);
+
+		size_t filled = 0;
+		while (filled < length) {
+			if (offset == 0) {
+				buffer[5 + filled++] = 0;
+				offset = 1;
+				continue;
+			}
+			size_t take = rowBytes - offset;
+			if (take > length - filled) {
+				take = length - filled;
+			}
+			memcpy(buffer + 5 + filled, image + row * (rowBytes - 1) + (offset - 1), take);
+			filled += take;
+			offset += take;
+			if (offset == rowBytes) {
+				row++;
+				offset = 0;
+			}
+		}
+
+		// Adler-32，每 5552 字节取一次模，保证 32 位不溢出
+		const unsigned char* p = buffer + 5;
+		size_t left = length;
+		while (left > 0) {
+			size_t chunk = left < 5552 ? left : 5552;
+			left -= chunk;
+			while (chunk-- > 0) {
+				adlerA += *p++;
+				adlerB += adlerA;
+			}
+			adlerA %= 65521;
+			adlerB %= 65521;
+		}
+
+		writeChunk(out, "IDAT", buffer, (uint32_t)(length + 5));
+	} while (remaining > 0);
+
+	unsigned char adler[4];
+	putBigEndian(adler, (adlerB << 16) | adlerA);
+	writeChunk(out, "IDAT", adler, 4);
+	writeChunk(out, "IEND", nullptr, 0);
+}
@@ -0,0 +1,81 @@
+﻿#pragma once
+#include <iosfwd>
+#include "Vector.h"
+
+/**
+ * 不依赖 OpenCV 的离屏 RGB 图像，像素按行连续存放（每像素 3 字节）。
+ *
+ * 可以直接写出 PPM（P6）或 PNG 文件。PNG 使用未压缩的 deflate 存储块，
+ * 按 64 KB 一块流式写出，不需要额外的压缩库，也不需要在内存中再保存一份编码后的数据。
+ */
+class RasterImage {
+private:
+	int width_; // 宽度（像素）
+	int height_; // 高度（像素）
+	Vector<unsigned char> pixels; // RGB 像素
+
+public:
+	/**
+	 * 构造函数，创建一张纯色图像。
+	 *
+	 * @param width 宽度
+	 * @param height 高度
+	 * @param r 背景红色分量
+	 * @param g 背景绿色分量
+	 * @param b 背景蓝色分量
+	 */
+	RasterImage(int width, int height, unsigned char r = 255, unsigned char g = 255, unsigned char b = 255);
+
+	int width() const;
+	int height() const;
+
+	/**
+	 * 获取像素缓冲区，第 y 行第 x 列的像素位于 data()[(y * width() + x) * 3]。
+	 *
+	 * @return 像素缓冲区
+	 */
+	unsigned char* data();
+	const unsigned char* data() const;
+
+	/**
+	 * 填充矩形，超出图像的部分被裁剪。
+	 *
+	 * @param x 左上角横坐标
+	 * @param y 左上角纵坐标
+	 * @param w 宽度
+	 * @param h 高度
+	 */
+	void fillRect(int x, int y, int w, int h, unsigned char r, unsigned char g, unsigned char b);
+
+	/**
+	 * 画一条 1 像素宽的线段（Bresenham 算法），超出图像的部分被裁剪。
+	 */
+	void drawLine(int x0, int y0, int x1, int y1, unsigned char r, unsigned char g, unsigned char b);
+
+	/**
+	 * 以二进制 PPM（P6）格式写出。
+	 *
+	 * @param fileName 文件名
+	 * @return 写入成功返回 true，否则返回 false
+	 */
+	bool writePPM(const char* fileName) const;
+
+	/**
+	 * 以 PNG 格式写出（8 位 RGB，不压缩）。
+	 *
+	 * @param fileName 文件名
+	 * @return 写入成功返回 true，否则返回 false
+	 */
+	bool writePNG(const char* fileName) const;
+
+	/**
+	 * 按扩展名选择格式写出：.ppm 写 PPM，其他写 PNG。
+	 *
+	 * @param fileName 文件名
+	 * @return 写入成功返回 true，否则返回 false
+	 */
+	bool write(const char* fileName) const;
+
+private:
+	void writePNGStream(std::ostream& out) const;
+};
@@ -0,0 +1,127 @@
+﻿#pragma once
+#include <cstddef>
+
+/**
+ * 一次搜索的统计计数，由 Chessboard 的各个搜索函数填写，用于分析某次查询慢在哪里。
+ *
+ * 只有定义了 KNIGHT_SEARCH_STATS 宏时才会计数；未定义时各搜索函数使用 StatsRecorder<false>，
+ * 它的成员函数都是空的内联函数，计数代码被编译器完全消除，计数始终为 0。
+ */
+struct SearchStats {
+	unsigned long long nodesPopped; // 从队列（或递归栈）中取出的节点数
+	unsigned long long neighboursGenerated; // 生成的相邻格子数
+	unsigned long long invalidRejections; // 被 isValid 拒绝的相邻格子数
+	size_t maxQueueSize; // 队列的最大长度
+	size_t peakScratchBytes; // 搜索网格占用内存的峰值
+	size_t allocations; // 堆分配次数（每次入队分配一个链表节点，以及网格缓冲区）
+
+	SearchStats() {
+		reset();
+	}
+
+	/**
+	 * 清空所有计数。
+	 */
+	void reset() {
+		nodesPopped = 0;
+		neighboursGenerated = 0;
+		invalidRejections = 0;
+		maxQueueSize = 0;
+		peakScratchBytes = 0;
+		allocations = 0;
+	}
+};
+
+#ifdef KNIGHT_SEARCH_STATS
+const bool SEARCH_STATS_ENABLED = true;
+#else
+const bool SEARCH_STATS_ENABLED = false;
+#endif
+
+/**
+ * 向 SearchStats 写入计数的记录器。
+ *
+ * @tparam Enabled 为 false 时使用下面的空特化
+ */
+template<bool Enabled>
+class StatsRecorder {
+private:
+	SearchStats& stats;
+
+public:
+	explicit StatsRecorder(SearchStats& stats_) : stats(stats_) {}
+
+	/**
+	 * 开始一次新的搜索，清空计数。
+	 */
+	void reset() {
+		stats.reset();
+	}
+
+	/**
+	 * 记录取出一个节点。
+	 */
+	void popped() {
+		stats.nodesPopped++;
+	}
+
+	/**
+	 * 记录生成一个相邻格子及其 isValid 检查结果。
+	 *
+	 * @param valid isValid 的结果
+	 * @return 原样返回 valid，便于直接放在条件表达式中
+	 */
+	bool checked(bool valid) {
+		stats.neighboursGenerated++;
+		if (!valid) {
+			stats.invalidRejections++;
+		}
+		return valid;
+	}
+
+	/**
+	 * 记录一次入队（链表队列每次入队分配一个节点）。
+	 *
+	 * @param queueSize 入队后的队列长度
+	 */
+	void pushed(size_t queueSize) {
+		stats.allocations++;
+		if (queueSize > stats.maxQueueSize) {
+			stats.maxQueueSize = queueSize;
+		}
+	}
+
+	/**
+	 * 记录搜索网格当前占用的内存。
+	 *
+	 * @param bytes 已分配的字节数
+	 */
+	void scratch(size_t bytes) {
+		if (bytes > stats.peakScratchBytes) {
+			stats.peakScratchBytes = bytes;
+		}
+	}
+
+	/**
+	 * 记录其他堆分配。
+	 *
+	 * @param count 分配次数
+	 */
+	void allocated(size_t count = 1) {
+		stats.allocations += count;
+	}
+};
+
+template<>
+class StatsRecorder<false> {
+public:
+	explicit StatsRecorder(SearchStats&) {}
+	void reset() {}
+	void popped() {}
+	bool checked(bool valid) { return valid; }
+	void pushed(size_t) {}
+	void scratch(size_t) {}
+	void allocated(size_t = 1) {}
+};
+
+typedef StatsRecorder<SEARCH_STATS_ENABLED> SearchRecorder;
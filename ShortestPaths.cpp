@@ -0,0 +1,127 @@
+﻿#include "ShortestPaths.h"
+
+typedef ShortestPaths::Position Position;
+
+const unsigned long long ShortestPaths::DEFAULT_MODULUS;
+
+ShortestPaths::ShortestPaths(Chessboard& board, const Position& start_, const Position& target_)
+	: boardSize(board.size()), start(start_), target(target_) {
+	// 在弹出终点时停止：此时所有跳数不超过终点跳数的格子都已得到准确的距离
+	field = board.distanceField(start, target);
+}
+
+int ShortestPaths::distance(int x, int y) const {
+	if (x < 1 || x > boardSize || y < 1 || y > boardSize) {
+		return Chessboard::UNREACHED;
+	}
+	return field.begin()[(size_t)(x - 1) * boardSize + (y - 1)];
+}
+
+int ShortestPaths::jumps() const {
+	int d = distance(target.x, target.y);
+	return d == Chessboard::UNREACHED ? -1 : d;
+}
+
+unsigned long long ShortestPaths::count(unsigned long long modulus) const {
+	int total = jumps();
+	if (total < 0) {
+		return 0;
+	}
+
+	// 从终点向起点逐层收集最短路径经过的格子，layers[d] 为跳数为 d 的那一层
+	size_t cells = (size_t)boardSize * boardSize;
+	Vector<unsigned char> onPath(cells, 0);
+	Vector<Vector<Position>> layers(total + 1);
+	layers[total].push_back(target);
+	for (int d = total; d > 0; d--) {
+		for (int k = 0; k < layers[d].size(); k++) {
+			Position curr = layers[d][k];
+			for (int i = 0; i < 8; i++) {
+				int prevX = curr.x + Chessboard::dx[i];
+				int prevY = curr.y + Chessboard::dy[i];
+				if (distance(prevX, prevY) != d - 1) {
+					continue;
+				}
+				unsigned char& mark = onPath.begin()[(size_t)(prevX - 1) * boardSize + (prevY - 1)];
+				if (!mark) {
+					mark = 1;
+					layers[d - 1].push_back(Position(prevX, prevY));
+				}
+			}
+		}
+	}
+
+	// 按层正向动态规划：到达某格的最短路径数等于其所有前驱的路径数之和。
+	// modulus 为 0 时不显式取模，计数按 unsigned long long 自然回绕（即对 2^64 取模）
+	Vector<unsigned long long> ways(cells, 0);
+	unsigned long long* w = ways.begin();
+	w[(size_t)(start.x - 1) * boardSize + (start.y - 1)] = modulus == 1 ? 0 : 1;
+	for (int d = 1; d <= total; d++) {
+		for (int k = 0; k < layers[d].size(); k++) {
+			Position curr = layers[d][k];
+			unsigned long long sum = 0;
+			for (int i = 0; i < 8; i++) {
+				int prevX = curr.x + Chessboard::dx[i];
+				int prevY = curr.y + Chessboard::dy[i];
+				if (distance(prevX, prevY) == d - 1) {
+					sum += w[(size_t)(prevX - 1) * boardSize + (prevY - 1)];
+					if (modulus != 0) {
+						sum %= modulus;
+					}
+				}
+			}
+			w[(size_t)(curr.x - 1) * boardSize + (curr.y - 1)] = sum;
+		}
+	}
+	return w[(size_t)(target.x - 1) * boardSize + (target.y - 1)];
+}
+
+ShortestPaths::Enumerator ShortestPaths::enumerate() const {
+	return Enumerator(this);
+}
+
+ShortestPaths::Enumerator::Enumerator(const ShortestPaths* owner_) : owner(owner_), top(-1), started(false) {}
+
+bool ShortestPaths::Enumerator::next(Vector<Position>& path) {
+	if (!started) {
+		started = true;
+		int total = owner->jumps();
+		if (total < 0) {
+			return false;
+		}
+		cells = Vector<Position>(total + 1);
+		moves = Vector<int>(total + 1, 0);
+		cells[0] = owner->target;
+		top = 0;
+	} else if (top >= 0) {
+		// 上一次停在起点，回退一层继续尝试其他前驱
+		top--;
+	}
+
+	while (top >= 0) {
+		Position curr = cells[top];
+		int d = owner->distance(curr.x, curr.y);
+		if (d == 0) {
+			path = Vector<Position>(cells.begin(), cells.begin() + top + 1);
+			return true;
+		}
+
+		bool advanced = false;
+		while (moves[top] < 8) {
+			int i = moves[top]++;
+			int prevX = curr.x + Chessboard::dx[i];
+			int prevY = curr.y + Chessboard::dy[i];
+			if (owner->distance(prevX, prevY) == d - 1) {
+				cells[top + 1] = Position(prevX, prevY);
+				moves[top + 1] = 0;
+				top++;
+				advanced = true;
+				break;
+			}
+		}
+		if (!advanced) {
+			top--;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,88 @@
+﻿#pragma once
+#include "Chessboard.h"
+#include "Vector.h"
+
+/**
+ * 基于广度优先搜索距离层的最短路径计数与枚举。
+ *
+ * 构造时计算一次起点的距离场；所有最短路径都只沿“距离恰好加一”的边前进，
+ * 因此计数可以在距离层上做动态规划，枚举可以从终点沿“距离恰好减一”的相邻格子回溯，
+ * 任何一条回溯分支都一定能走到起点，不需要剪枝也不会走进死路。
+ */
+class ShortestPaths {
+public:
+	typedef Chessboard::Position Position;
+	static const unsigned long long DEFAULT_MODULUS = 1000000007ULL;
+
+	/**
+	 * 逐条产生最短路径的惰性枚举器，只保存当前路径和每层的回溯位置，内存为 O(跳数)。
+	 */
+	class Enumerator {
+	private:
+		const ShortestPaths* owner; // 所属的 ShortestPaths
+		Vector<Position> cells; // 当前路径，cells[0] 为终点
+		Vector<int> moves; // 每层下一个要尝试的走法下标
+		int top; // 当前路径最后一个格子的下标
+		bool started; // 是否已经产生过路径
+
+	public:
+		/**
+		 * 构造函数。
+		 *
+		 * @param owner_ 所属的 ShortestPaths，必须比枚举器活得久
+		 */
+		explicit Enumerator(const ShortestPaths* owner_);
+
+		/**
+		 * 产生下一条最短路径。
+		 *
+		 * @param path 输出，路径位置列表（终点在前）
+		 * @return 还有路径时返回 true，枚举结束时返回 false
+		 */
+		bool next(Vector<Position>& path);
+	};
+
+private:
+	int boardSize; // 棋盘大小
+	Position start; // 起始位置
+	Position target; // 目标位置
+	Vector<unsigned short> field; // 起点的距离场
+
+public:
+	/**
+	 * 构造函数，计算起点的距离场。不修改 board 上原来的起点和终点，只借用它的棋盘大小和搜索统计。
+	 *
+	 * @param board 棋盘
+	 * @param start_ 起始位置
+	 * @param target_ 目标位置
+	 */
+	ShortestPaths(Chessboard& board, const Position& start_, const Position& target_);
+
+	/**
+	 * 获取最小跳数。
+	 *
+	 * @return 最小跳数，不可达时返回 -1
+	 */
+	int jumps() const;
+
+	/**
+	 * 统计不同最短路径的条数（对 modulus 取模）。
+	 *
+	 * @param modulus 模数，为 0 时不取模，结果为对 2^64 自然回绕后的值
+	 * @return 最短路径条数模 modulus，不可达时为 0
+	 */
+	unsigned long long count(unsigned long long modulus = DEFAULT_MODULUS) const;
+
+	/**
+	 * 创建一个从头开始的最短路径枚举器。
+	 *
+	 * @return 枚举器
+	 */
+	Enumerator enumerate() const;
+
+private:
+	/**
+	 * 获取格子到起点的跳数，越界或未到达时返回 Chessboard::UNREACHED。
+	 */
+	int distance(int x, int y) const;
+};
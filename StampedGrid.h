@@ -0,0 +1,108 @@
+﻿#pragma once
+#include "Vector.h"
+
+/**
+ * 带查询代数（epoch）标记的平铺网格，用作可跨查询复用的搜索暂存区。
+ *
+ * 每个格子保存写入时的代数，只有代数等于当前代数的格子才被视为已写入，
+ * 因此每次查询开始时只需把代数加一，不必把整张网格重新初始化。
+ */
+template<typename T>
+class StampedGrid {
+private:
+	struct Cell {
+		unsigned int stamp; // 写入时的代数
+		T value; // 格子的值
+	};
+
+	Vector<Cell> cells; // 所有格子
+	unsigned int epoch; // 当前代数
+
+public:
+	/**
+	 * 默认构造函数，创建一个空网格，第一次 reset 时才分配。
+	 */
+	StampedGrid();
+
+	/**
+	 * 开始新的一次查询。网格大小不同时重新分配，否则只递增代数。
+	 *
+	 * @param count 格子数
+	 */
+	void reset(size_t count);
+
+	/**
+	 * 检查格子在本次查询中是否已写入。
+	 *
+	 * @param idx 格子下标
+	 * @return 已写入返回 true，否则返回 false
+	 */
+	bool contains(size_t idx) const;
+
+	/**
+	 * 读取本次查询中已写入的格子。
+	 *
+	 * @param idx 格子下标
+	 * @return 格子的值
+	 */
+	const T& get(size_t idx) const;
+
+	/**
+	 * 获取格子的可写引用，并把它标记为本次查询已写入。
+	 *
+	 * @param idx 格子下标
+	 * @return 格子的引用
+	 */
+	T& at(size_t idx);
+
+	/**
+	 * 获取已分配的内存大小。
+	 *
+	 * @return 已分配的字节数
+	 */
+	size_t allocatedBytes() const;
+};
+
+template<typename T>
+StampedGrid<T>::StampedGrid() : epoch(0) {}
+
+template<typename T>
+void StampedGrid<T>::reset(size_t count) {
+	if (cells.size() != count) {
+		cells = Vector<Cell>(count, Cell{ 0, T() });
+		epoch = 1;
+		return;
+	}
+
+	epoch++;
+	if (epoch == 0) {
+		// 代数回绕时清空一次所有标记
+		Cell* data = cells.begin();
+		for (size_t i = 0; i < count; i++) {
+			data[i].stamp = 0;
+		}
+		epoch = 1;
+	}
+}
+
+template<typename T>
+bool StampedGrid<T>::contains(size_t idx) const {
+	return cells.begin()[idx].stamp == epoch;
+}
+
+template<typename T>
+const T& StampedGrid<T>::get(size_t idx) const {
+	return cells.begin()[idx].value;
+}
+
+template<typename T>
+T& StampedGrid<T>::at(size_t idx) {
+	Cell& cell = cells.begin()[idx];
+	cell.stamp = epoch;
+	return cell.value;
+}
+
+template<typename T>
+size_t StampedGrid<T>::allocatedBytes() const {
+	return cells.capacity() * sizeof(Cell);
+}
@@ -0,0 +1,85 @@
+﻿#pragma once
+#include "Chessboard.h"
+
+/**
+ * 正方形棋盘的 8 种对称变换（二面体群 D4）。变换编号 op 的含义：
+ * 第 0 位翻转横坐标，第 1 位翻转纵坐标，第 2 位在翻转之后交换横纵坐标。
+ * 这些变换都把马的走法映射为马的走法，因此保持任意两格之间的跳数不变。
+ */
+
+/**
+ * 对位置施加对称变换。
+ *
+ * @param op 变换编号（0 到 7）
+ * @param pos 位置
+ * @param n 棋盘大小
+ * @return 变换后的位置
+ */
+inline Chessboard::Position applySymmetry(int op, const Chessboard::Position& pos, int n) {
+	int x = (op & 1) ? n + 1 - pos.x : pos.x;
+	int y = (op & 2) ? n + 1 - pos.y : pos.y;
+	return (op & 4) ? Chessboard::Position(y, x) : Chessboard::Position(x, y);
+}
+
+/**
+ * 对位置施加对称变换的逆变换。
+ *
+ * @param op 变换编号（0 到 7）
+ * @param pos 变换后的位置
+ * @param n 棋盘大小
+ * @return 原位置
+ */
+inline Chessboard::Position invertSymmetry(int op, const Chessboard::Position& pos, int n) {
+	int x = (op & 4) ? pos.y : pos.x;
+	int y = (op & 4) ? pos.x : pos.y;
+	return Chessboard::Position((op & 1) ? n + 1 - x : x, (op & 2) ? n + 1 - y : y);
+}
+
+/**
+ * 求把位置映射到基本区域 1 <= x <= y <= (n + 1) / 2 的变换。
+ *
+ * @param pos 位置
+ * @param n 棋盘大小
+ * @return 变换编号
+ */
+inline int canonicalSymmetry(const Chessboard::Position& pos, int n) {
+	int op = 0;
+	int x = pos.x;
+	int y = pos.y;
+	if (2 * x > n + 1) {
+		op |= 1;
+		x = n + 1 - x;
+	}
+	if (2 * y > n + 1) {
+		op |= 2;
+		y = n + 1 - y;
+	}
+	if (x > y) {
+		op |= 4;
+	}
+	return op;
+}
+
+/**
+ * 基本区域中位置的编号，按行依次排列。
+ *
+ * @param pos 基本区域中的位置
+ * @param n 棋盘大小
+ * @return 编号（0 到 canonicalCount(n) - 1）
+ */
+inline int canonicalIndex(const Chessboard::Position& pos, int n) {
+	int half = (n + 1) / 2;
+	int row = pos.x - 1;
+	return row * half - row * (row - 1) / 2 + (pos.y - pos.x);
+}
+
+/**
+ * 基本区域中的格子数。
+ *
+ * @param n 棋盘大小
+ * @return 格子数
+ */
+inline int canonicalCount(int n) {
+	int half = (n + 1) / 2;
+	return half * (half + 1) / 2;
+}
@@ -0,0 +1,61 @@
+#include <cstring>
+
+#include "TextBuffer.h"
+
+TextBuffer::TextBuffer(std::ostream& out_, size_t capacity) : out(out_), buffer(capacity), used(0) {}
+
+TextBuffer::~TextBuffer() {
+	flush();
+}
+
+void TextBuffer::append(const char* text, size_t length) {
+	if (used + length > buffer.size()) {
+		flush();
+		if (length > buffer.size()) {
+			out.write(text, length);
+			return;
+		}
+	}
+	memcpy(buffer.begin() + used, text, length);
+	used += length;
+}
+
+void TextBuffer::append(const char* text) {
+	append(text, strlen(text));
+}
+
+void TextBuffer::appendChar(char c) {
+	if (used == buffer.size()) {
+		flush();
+	}
+	buffer.begin()[used++] = c;
+}
+
+void TextBuffer::appendInt(long long value) {
+	appendPadded(value, 0);
+}
+
+void TextBuffer::appendPadded(long long value, int width) {
+	char digits[24];
+	char* end = digits + sizeof(digits);
+	char* p = end;
+	unsigned long long magnitude = value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+	do {
+		*--p = (char)('0' + magnitude % 10);
+		magnitude /= 10;
+	} while (magnitude != 0);
+	if (value < 0) {
+		*--p = '-';
+	}
+	for (int pad = width - (int)(end - p); pad > 0; pad--) {
+		appendChar(' ');
+	}
+	append(p, end - p);
+}
+
+void TextBuffer::flush() {
+	if (used > 0) {
+		out.write(buffer.begin(), used);
+		used = 0;
+	}
+}
@@ -0,0 +1,73 @@
+﻿#pragma once
+#include <iostream>
+#include "Vector.h"
+
+/**
+ * 面向输出流的文本缓冲区。内容先写入一块固定大小的内存，
+ * 满了或显式调用 flush 时才一次性写入底层输出流，避免逐字符输出和逐行刷新。
+ */
+class TextBuffer {
+private:
+	std::ostream& out; // 底层输出流
+	Vector<char> buffer; // 缓冲区
+	size_t used; // 缓冲区中已使用的字节数
+
+public:
+	/**
+	 * 构造函数，创建一个写入指定输出流的缓冲区。
+	 *
+	 * @param out_ 底层输出流
+	 * @param capacity 缓冲区大小（字节）
+	 */
+	explicit TextBuffer(std::ostream& out_, size_t capacity = 1 << 16);
+
+	/**
+	 * 析构函数，把剩余内容写入输出流。
+	 */
+	~TextBuffer();
+
+	TextBuffer(const TextBuffer&) = delete;
+	TextBuffer& operator=(const TextBuffer&) = delete;
+
+	/**
+	 * 追加一段文本。
+	 *
+	 * @param text 文本起始地址
+	 * @param length 文本长度
+	 */
+	void append(const char* text, size_t length);
+
+	/**
+	 * 追加一个以 '\0' 结尾的字符串。
+	 *
+	 * @param text 字符串
+	 */
+	void append(const char* text);
+
+	/**
+	 * 追加一个字符。
+	 *
+	 * @param c 字符
+	 */
+	void appendChar(char c);
+
+	/**
+	 * 以十进制追加一个整数。
+	 *
+	 * @param value 整数值
+	 */
+	void appendInt(long long value);
+
+	/**
+	 * 以十进制追加一个整数，不足指定宽度时在左侧补空格（与 setw 相同）。
+	 *
+	 * @param value 整数值
+	 * @param width 最小宽度
+	 */
+	void appendPadded(long long value, int width);
+
+	/**
+	 * 把缓冲区内容写入底层输出流。
+	 */
+	void flush();
+};
@@ -0,0 +1,169 @@
+﻿#pragma once
+#include "Vector.h"
+
+/**
+ * 按 64 x 64 分块、首次写入时才分配的稀疏网格，可用作已访问标记或距离表。
+ *
+ * 每个块记录自己所属的代数（generation）。reset 只把全局代数加一，
+ * 代数不匹配的块在读取时视为全部是初始值，在写入时才清空，因此清空整张网格是 O(1) 的，
+ * 一次只涉及局部区域的查询也只会分配并清空它实际触及的少数几个块。
+ */
+template<typename T>
+class TiledGrid {
+private:
+	static const int TILE_BITS = 6;
+	static const int TILE_SIZE = 1 << TILE_BITS;
+	static const int TILE_MASK = TILE_SIZE - 1;
+
+	struct Tile {
+		unsigned int generation; // 块内数据所属的代数
+		T cells[TILE_SIZE * TILE_SIZE]; // 块内的格子，按行排列
+	};
+
+	int size_; // 网格边长
+	int tilesPerSide; // 每行（列）的块数
+	unsigned int generation; // 当前代数
+	T initial; // 格子的初始值
+	Vector<Tile**> rows; // 每一行块的指针数组，首次写入该行时才分配
+	size_t tileCount; // 已分配的块数
+
+public:
+	/**
+	 * 构造函数，创建一个边长为 size 的网格，不立即分配任何块。
+	 *
+	 * @param size 网格边长，坐标范围为 0 到 size - 1
+	 * @param initial_ 格子的初始值
+	 */
+	TiledGrid(int size, const T& initial_ = T());
+
+	/**
+	 * 析构函数，释放所有已分配的块。
+	 */
+	~TiledGrid();
+
+	TiledGrid(const TiledGrid&) = delete;
+	TiledGrid& operator=(const TiledGrid&) = delete;
+
+	/**
+	 * 把所有格子恢复为初始值。只递增代数，不访问任何块。
+	 */
+	void reset();
+
+	/**
+	 * 读取格子的值，不分配内存。
+	 *
+	 * @param x 横坐标
+	 * @param y 纵坐标
+	 * @return 格子的值
+	 */
+	const T& get(int x, int y) const;
+
+	/**
+	 * 获取格子的可写引用，所在块未分配或已过期时先分配或清空。
+	 *
+	 * @param x 横坐标
+	 * @param y 纵坐标
+	 * @return 格子的引用
+	 */
+	T& at(int x, int y);
+
+	/**
+	 * 获取已分配的内存大小。
+	 *
+	 * @return 已分配的字节数
+	 */
+	size_t allocatedBytes() const;
+
+private:
+	/**
+	 * 把所有已分配的块标记为过期，在代数溢出回绕时使用。
+	 */
+	void expireAll();
+};
+
+template<typename T>
+TiledGrid<T>::TiledGrid(int size, const T& initial_)
+	: size_(size), tilesPerSide((size + TILE_MASK) >> TILE_BITS), generation(1), initial(initial_),
+	rows(tilesPerSide, nullptr), tileCount(0) {}
+
+template<typename T>
+TiledGrid<T>::~TiledGrid() {
+	for (int i = 0; i < tilesPerSide; i++) {
+		Tile** row = rows[i];
+		if (row == nullptr) {
+			continue;
+		}
+		for (int j = 0; j < tilesPerSide; j++) {
+			delete row[j];
+		}
+		delete[] row;
+	}
+}
+
+template<typename T>
+void TiledGrid<T>::reset() {
+	generation++;
+	if (generation == 0) {
+		expireAll();
+		generation = 1;
+	}
+}
+
+template<typename T>
+const T& TiledGrid<T>::get(int x, int y) const {
+	Tile** row = rows[x >> TILE_BITS];
+	if (row == nullptr) {
+		return initial;
+	}
+	const Tile* tile = row[y >> TILE_BITS];
+	if (tile == nullptr || tile->generation != generation) {
+		return initial;
+	}
+	return tile->cells[((x & TILE_MASK) << TILE_BITS) | (y & TILE_MASK)];
+}
+
+template<typename T>
+T& TiledGrid<T>::at(int x, int y) {
+	Tile**& row = rows[x >> TILE_BITS];
+	if (row == nullptr) {
+		row = new Tile*[tilesPerSide]();
+	}
+	Tile*& tile = row[y >> TILE_BITS];
+	if (tile == nullptr) {
+		tile = new Tile;
+		tileCount++;
+		tile->generation = 0;
+	}
+	if (tile->generation != generation) {
+		for (int k = 0; k < TILE_SIZE * TILE_SIZE; k++) {
+			tile->cells[k] = initial;
+		}
+		tile->generation = generation;
+	}
+	return tile->cells[((x & TILE_MASK) << TILE_BITS) | (y & TILE_MASK)];
+}
+
+template<typename T>
+size_t TiledGrid<T>::allocatedBytes() const {
+	size_t bytes = tileCount * sizeof(Tile);
+	for (int i = 0; i < tilesPerSide; i++) {
+		if (rows[i] != nullptr) {
+			bytes += tilesPerSide * sizeof(Tile*);
+		}
+	}
+	return bytes;
+}
+
+template<typename T>
+void TiledGrid<T>::expireAll() {
+	for (int i = 0; i < tilesPerSide; i++) {
+		if (rows[i] == nullptr) {
+			continue;
+		}
+		for (int j = 0; j < tilesPerSide; j++) {
+			if (rows[i][j] != nullptr) {
+				rows[i][j]->generation = 0;
+			}
+		}
+	}
+}
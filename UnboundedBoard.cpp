@@ -0,0 +1,107 @@
+﻿#include <climits>
+#include <utility>
+
+#include "UnboundedBoard.h"
+
+typedef UnboundedBoard::Position Position;
+
+UnboundedBoard::UnboundedBoard(int bound_) : bound(bound_), explored(0) {}
+
+bool UnboundedBoard::isValid(int x, int y) const {
+	return bound == 0 || (x >= 1 && x <= bound && y >= 1 && y <= bound);
+}
+
+unsigned long long UnboundedBoard::key(int x, int y) {
+	return ((unsigned long long)(unsigned int)x << 32) | (unsigned int)y;
+}
+
+size_t UnboundedBoard::exploredCells() const {
+	return explored;
+}
+
+bool UnboundedBoard::expandLayer(Vector<Position>& frontier, VisitMap& visits, const VisitMap& other, Position& meet, int& best) {
+	Vector<Position> next;
+	bool met = false;
+	for (int k = 0; k < frontier.size(); k++) {
+		Position curr = frontier[k];
+		int nextDepth = visits[key(curr.x, curr.y)].depth + 1;
+		for (int i = 0; i < 8; i++) {
+			int nextX = curr.x + Chessboard::dx[i];
+			int nextY = curr.y + Chessboard::dy[i];
+			if (!isValid(nextX, nextY)) {
+				continue;
+			}
+
+			unsigned long long nextKey = key(nextX, nextY);
+			if (!visits.insert({ nextKey, { nextDepth, i } }).second) {
+				continue;
+			}
+			next.push_back(Position(nextX, nextY));
+
+			VisitMap::const_iterator found = other.find(nextKey);
+			if (found != other.end() && nextDepth + found->second.depth < best) {
+				best = nextDepth + found->second.depth;
+				meet = Position(nextX, nextY);
+				met = true;
+			}
+		}
+	}
+	frontier = std::move(next);
+	return met;
+}
+
+void UnboundedBoard::traceBack(const VisitMap& visits, Position curr, Vector<Position>& path) {
+	int move = visits.find(key(curr.x, curr.y))->second.move;
+	while (move >= 0) {
+		curr = Position(curr.x - Chessboard::dx[move], curr.y - Chessboard::dy[move]);
+		path.push_back(curr);
+		move = visits.find(key(curr.x, curr.y))->second.move;
+	}
+}
+
+Vector<Position> UnboundedBoard::shortestPath(const Position& start, const Position& target) {
+	explored = 0;
+	if (!isValid(start.x, start.y) || !isValid(target.x, target.y)) {
+		return Vector<Position>();
+	}
+	if (start.x == target.x && start.y == target.y) {
+		Vector<Position> path;
+		path.push_back(start);
+		explored = 1;
+		return path;
+	}
+
+	VisitMap fromStart, fromTarget;
+	fromStart[key(start.x, start.y)] = { 0, -1 };
+	fromTarget[key(target.x, target.y)] = { 0, -1 };
+	Vector<Position> startFrontier, targetFrontier;
+	startFrontier.push_back(start);
+	targetFrontier.push_back(target);
+
+	// 每次扩展较小的一侧；一层内取跳数最少的相遇点
+	Position meet;
+	int best = INT_MAX;
+	bool met = false;
+	while (!met && !startFrontier.empty() && !targetFrontier.empty()) {
+		if (startFrontier.size() <= targetFrontier.size()) {
+			met = expandLayer(startFrontier, fromStart, fromTarget, meet, best);
+		} else {
+			met = expandLayer(targetFrontier, fromTarget, fromStart, meet, best);
+		}
+	}
+	explored = fromStart.size() + fromTarget.size();
+	if (!met) {
+		return Vector<Position>();
+	}
+
+	// 终点在前：终点 -> 相遇点 -> 起点
+	Vector<Position> toTarget;
+	traceBack(fromTarget, meet, toTarget);
+	Vector<Position> path;
+	for (int k = toTarget.size() - 1; k >= 0; k--) {
+		path.push_back(toTarget[k]);
+	}
+	path.push_back(meet);
+	traceBack(fromStart, meet, path);
+	return path;
+}
@@ -0,0 +1,76 @@
+﻿#pragma once
+#include <unordered_map>
+#include "Chessboard.h"
+#include "Vector.h"
+
+/**
+ * 无界（或极大）棋盘上的跳马求解器。
+ *
+ * 不分配与棋盘大小相关的网格，已访问的格子保存在哈希表中，
+ * 从起点和终点同时做双向广度优先搜索，内存只与实际搜索过的区域成正比。
+ */
+class UnboundedBoard {
+public:
+	typedef Chessboard::Position Position;
+
+private:
+	struct Visit {
+		int depth; // 到本侧搜索源的跳数
+		int move; // 到达该格子所用走法的下标，搜索源为 -1
+	};
+	typedef std::unordered_map<unsigned long long, Visit> VisitMap;
+
+	int bound; // 坐标范围为 1 到 bound，为 0 时表示无界
+	size_t explored; // 上一次搜索访问过的格子数
+
+public:
+	/**
+	 * 构造函数。
+	 *
+	 * @param bound_ 棋盘大小，为 0 时表示无界棋盘（坐标可以取任意整数）
+	 */
+	explicit UnboundedBoard(int bound_ = 0);
+
+	/**
+	 * 检查坐标是否在棋盘范围内。
+	 *
+	 * @param x 横坐标
+	 * @param y 纵坐标
+	 * @return 在范围内返回 true，否则返回 false
+	 */
+	bool isValid(int x, int y) const;
+
+	/**
+	 * 使用双向广度优先搜索寻找最优路径。
+	 *
+	 * @param start 起始位置
+	 * @param target 目标位置
+	 * @return 路径位置列表（与 Chessboard 各求解函数相同，终点在前），不可达时返回空列表
+	 */
+	Vector<Position> shortestPath(const Position& start, const Position& target);
+
+	/**
+	 * 获取上一次搜索访问过的格子数，用于衡量搜索占用的内存。
+	 *
+	 * @return 访问过的格子数
+	 */
+	size_t exploredCells() const;
+
+private:
+	/**
+	 * 把坐标打包为哈希表的键。
+	 */
+	static unsigned long long key(int x, int y);
+
+	/**
+	 * 把一侧的搜索向外扩展一层，遇到另一侧已访问的格子时记录跳数最少的相遇点。
+	 *
+	 * @return 本层找到相遇点时返回 true
+	 */
+	bool expandLayer(Vector<Position>& frontier, VisitMap& visits, const VisitMap& other, Position& meet, int& best);
+
+	/**
+	 * 沿记录的走法从某个格子回溯到本侧的搜索源，依次追加到路径末尾（不含该格子本身）。
+	 */
+	static void traceBack(const VisitMap& visits, Position curr, Vector<Position>& path);
+};
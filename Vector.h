@@ -1,6 +1,15 @@
 #pragma once
-
-template<typename T>
+#include <stdexcept>
+#include <utility>
+#include "Allocator.h"
+
+/**
+ * 动态数组。
+ *
+ * @tparam T 元素类型
+ * @tparam Alloc 内存分配策略（见 Allocator.h）
+ */
+template<typename T, typename Alloc = DefaultAllocator>
 class Vector {
 private:
 	T* data;
@@ -84,7 +93,7 @@ public:
 	 * @param other 要拷贝的 Vector 对象
 	 * @return 拷贝后的当前 Vector 对象的引用
 	 */
-	Vector<T>& operator=(const Vector& other);
+	Vector& operator=(const Vector& other);
 
 	/**
 	 * 将当前 Vector 对象赋值为另一个 Vector 对象的移动。
@@ -92,7 +101,7 @@ public:
 	 * @param other 要移动的 Vector 对象
 	 * @return 移动后的当前 Vector 对象的引用
 	 */
-	Vector<T>& operator=(Vector&& other);
+	Vector& operator=(Vector&& other);
 
 	/**
 	 * 在 Vector 的末尾添加一个元素。
@@ -220,89 +229,82 @@ private:
 	void reserve(size_t newCapacity);
 };
 
-template<typename T>
-Vector<T>::Vector() : data(nullptr), capacity_(0), size_(0) {}
+template<typename T, typename Alloc>
+Vector<T, Alloc>::Vector() : data(nullptr), capacity_(0), size_(0) {}
 
-template<typename T>
-Vector<T>::Vector(size_t n, const T& elem) : data(nullptr), capacity_(n), size_(n) {
-	data = new T[capacity_];
+template<typename T, typename Alloc>
+Vector<T, Alloc>::Vector(size_t n, const T& elem) : data(nullptr), capacity_(n), size_(n) {
+	data = Alloc::template allocate<T>(capacity_);
 	for (size_t i = 0; i < size_; ++i) {
 		data[i] = elem;
 	}
 }
 
-template<typename T>
-Vector<T>::Vector(const Vector& other) : data(nullptr), capacity_(other.size_), size_(other.size_) {
-	data = new T[capacity_];
+template<typename T, typename Alloc>
+Vector<T, Alloc>::Vector(const Vector& other) : data(nullptr), capacity_(other.size_), size_(other.size_) {
+	data = Alloc::template allocate<T>(capacity_);
 	for (size_t i = 0; i < size_; ++i) {
 		data[i] = other.data[i];
 	}
 }
 
 
-template<typename T>
-Vector<T>::Vector(Vector&& other) : data(other.data), capacity_(other.capacity_), size_(other.size_) {
-	other.data = nullptr;
-	other.capacity_ = 0;
-	other.size_ = 0;
-}
-
-template<typename T>
-Vector<T>::Vector(Vector&& other) : data(other.data), capacity_(other.capacity_), size_(other.size_) {
+template<typename T, typename Alloc>
+Vector<T, Alloc>::Vector(Vector&& other) : data(other.data), capacity_(other.capacity_), size_(other.size_) {
 	other.data = nullptr;
 	other.capacity_ = 0;
 	other.size_ = 0;
 }
 
-template<typename T>
-Vector<T>::Vector(T* begin, T* end) : data(nullptr), capacity_(end - begin), size_(end - begin) {
-	data = new T[capacity_];
+template<typename T, typename Alloc>
+Vector<T, Alloc>::Vector(T* begin, T* end) : data(nullptr), capacity_(end - begin), size_(end - begin) {
+	data = Alloc::template allocate<T>(capacity_);
 	for (size_t i = 0; i < size_; ++i) {
 		data[i] = begin[i];
 	}
 }
 
-template<typename T>
-Vector<T>::~Vector() {
-	delete[] data;
+template<typename T, typename Alloc>
+Vector<T, Alloc>::~Vector() {
+	Alloc::deallocate(data, capacity_);
 }
 
-template<typename T>
-size_t Vector<T>::capacity() const {
+template<typename T, typename Alloc>
+size_t Vector<T, Alloc>::capacity() const {
 	return capacity_;
 }
 
-template<typename T>
-size_t Vector<T>::size() const {
+template<typename T, typename Alloc>
+size_t Vector<T, Alloc>::size() const {
 	return size_;
 }
 
-template<typename T>
-T& Vector<T>::operator[](int idx) {
+template<typename T, typename Alloc>
+T& Vector<T, Alloc>::operator[](int idx) {
 	if (idx < 0 || idx >= size_) {
 		throw std::out_of_range("Index out of range");
 	}
 	return data[idx];
 }
 
-template<typename T>
-const T& Vector<T>::operator[](int idx) const {
+template<typename T, typename Alloc>
+const T& Vector<T, Alloc>::operator[](int idx) const {
 	if (idx < 0 || idx >= size_) {
 		throw std::out_of_range("Index out of range");
 	}
 	return data[idx];
 }
 
-template<typename T>
-Vector<T>& Vector<T>::operator=(const Vector& other) {
+template<typename T, typename Alloc>
+Vector<T, Alloc>& Vector<T, Alloc>::operator=(const Vector& other) {
 	if (this == &other) {
 		return *this;
 	}
 
-	delete[] data;
+	Alloc::deallocate(data, capacity_);
 	capacity_ = other.size_;
 	size_ = other.size_;
-	data = new T[capacity_];
+	data = Alloc::template allocate<T>(capacity_);
 	for (size_t i = 0; i < size_; ++i) {
 		data[i] = other.data[i];
 	}
@@ -310,13 +312,13 @@ Vector<T>& Vector<T>::operator=(const Vector& other) {
 	return *this;
 }
 
-template<typename T>
-Vector<T>& Vector<T>::operator=(Vector&& other) {
+template<typename T, typename Alloc>
+Vector<T, Alloc>& Vector<T, Alloc>::operator=(Vector&& other) {
 	if (this == &other) {
 		return *this;
 	}
 
-	delete[] data;
+	Alloc::deallocate(data, capacity_);
 
 	data = other.data;
 	capacity_ = other.capacity_;
@@ -330,8 +332,8 @@ Vector<T>& Vector<T>::operator=(Vector&& other) {
 }
 
 
-template<typename T>
-void Vector<T>::push_back(const T& elem) {
+template<typename T, typename Alloc>
+void Vector<T, Alloc>::push_back(const T& elem) {
 	if (size_ == capacity_) {
 		if (capacity_ == 0) {
 			reserve(1);
@@ -343,41 +345,41 @@ void Vector<T>::push_back(const T& elem) {
 	size_++;
 }
 
-template<typename T>
-void Vector<T>::pop_back() {
+template<typename T, typename Alloc>
+void Vector<T, Alloc>::pop_back() {
 	if (size_ > 0) {
 		size_--;
 	}
 }
 
-template<typename T>
-T& Vector<T>::front() {
+template<typename T, typename Alloc>
+T& Vector<T, Alloc>::front() {
 	if (size_ == 0) {
 		throw std::length_error("Vector is empty");
 	}
 	return data[0];
 }
 
-template<typename T>
-T& Vector<T>::back() {
+template<typename T, typename Alloc>
+T& Vector<T, Alloc>::back() {
 	if (size_ == 0) {
 		throw std::length_error("Vector is empty");
 	}
 	return data[size_ - 1];
 }
 
-template<typename T>
-T* Vector<T>::begin() const {
+template<typename T, typename Alloc>
+T* Vector<T, Alloc>::begin() const {
 	return data;
 }
 
-template<typename T>
-T* Vector<T>::end() const {
+template<typename T, typename Alloc>
+T* Vector<T, Alloc>::end() const {
 	return data + size_;
 }
 
-template<typename T>
-void Vector<T>::insert(T* pos, const T& elem) {
+template<typename T, typename Alloc>
+void Vector<T, Alloc>::insert(T* pos, const T& elem) {
 	if (pos < data || pos > data + size_) {
 		throw std::out_of_range("Invalid position");
 	}
@@ -394,17 +396,17 @@ void Vector<T>::insert(T* pos, const T& elem) {
 	size_++;
 }
 
-template<typename T>
-void Vector<T>::insert(T* pos, size_t n, const T& elem) {
+template<typename T, typename Alloc>
+void Vector<T, Alloc>::insert(T* pos, size_t n, const T& elem) {
 	for (size_t i = 0; i < n; i++) {
 		insert(pos, elem);
 		pos++;
 	}
 }
 
-template<typename T>
+template<typename T, typename Alloc>
 template<typename Iter>
-void Vector<T>::insert(T* pos, Iter begin, Iter end) {
+void Vector<T, Alloc>::insert(T* pos, Iter begin, Iter end) {
 	size_t count = 0;
 	Iter it = begin;
 	while (it != end) {
@@ -419,9 +421,9 @@ void Vector<T>::insert(T* pos, Iter begin, Iter end) {
 	}
 }
 
-template<typename T>
+template<typename T, typename Alloc>
 template<typename U>
-void Vector<T>::resize(size_t newSize, const U& elem) {
+void Vector<T, Alloc>::resize(size_t newSize, const U& elem) {
 	if (newSize > size_) {
 		if (newSize > capacity_) {
 			reserve(newSize);
@@ -437,8 +439,8 @@ void Vector<T>::resize(size_t newSize, const U& elem) {
 	size_ = newSize;
 }
 
-template<typename T>
-T* Vector<T>::erase(T* pos) {
+template<typename T, typename Alloc>
+T* Vector<T, Alloc>::erase(T* pos) {
 	if (pos < data || pos >= data + size_) {
 		throw std::out_of_range("Invalid position");
 	}
@@ -450,8 +452,8 @@ T* Vector<T>::erase(T* pos) {
 	return pos;
 }
 
-template<typename T>
-T* Vector<T>::erase(T* begin, T* end) {
+template<typename T, typename Alloc>
+T* Vector<T, Alloc>::erase(T* begin, T* end) {
 	size_t count = end - begin;
 	for (size_t i = 0; i < count; i++) {
 		erase(begin);
@@ -459,13 +461,13 @@ T* Vector<T>::erase(T* begin, T* end) {
 	return begin;
 }
 
-template<typename T>
-bool Vector<T>::empty() const {
+template<typename T, typename Alloc>
+bool Vector<T, Alloc>::empty() const {
 	return size_ == 0;
 }
 
-template<typename T>
-void Vector<T>::resize(size_t newSize) {
+template<typename T, typename Alloc>
+void Vector<T, Alloc>::resize(size_t newSize) {
 	if (newSize > size_) {
 		if (newSize > capacity_) {
 			reserve(newSize);
@@ -481,8 +483,8 @@ void Vector<T>::resize(size_t newSize) {
 	size_ = newSize;
 }
 
-template<typename T>
-void Vector<T>::reverse(T* pos1, T* pos2) {
+template<typename T, typename Alloc>
+void Vector<T, Alloc>::reverse(T* pos1, T* pos2) {
 	if (pos1 < data || pos1 >= data + size_ || pos2 < data || pos2 >= data + size_) {
 		throw std::out_of_range("Invalid position");
 	}
@@ -495,13 +497,13 @@ void Vector<T>::reverse(T* pos1, T* pos2) {
 	}
 }
 
-template<typename T>
-void Vector<T>::reserve(size_t newCapacity) {
-	T* newData = new T[newCapacity];
+template<typename T, typename Alloc>
+void Vector<T, Alloc>::reserve(size_t newCapacity) {
+	T* newData = Alloc::template allocate<T>(newCapacity);
 	for (size_t i = 0; i < size_; i++) {
 		newData[i] = data[i];
 	}
-	delete[] data;
+	Alloc::deallocate(data, capacity_);
 	data = newData;
 	capacity_ = newCapacity;
 }
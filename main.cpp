@@ -1,12 +1,16 @@
 #include <iostream>
+#include <cstring>
 
 #include "Vector.h"
 #include "Queue.h"
 #include "Chessboard.h"
+#include "Driver.h"
 
 int main(int argc, char* argv[]) {
-	Chessboard chessboard(32);
-	chessboard.solve();
-
-	return 0;
+	// 不带参数时与原来相同：在 32 x 32 的棋盘上运行 Chessboard::solve()，参数说明见 Driver.h
+	Driver driver;
+	if (!driver.parse(argc, argv)) {
+		return 1;
+	}
+	return driver.run();
 }